@@ -0,0 +1,267 @@
+// Döşeme yerleşimleri: X'e bağımlılığı olmayan saf hesaplama. Pencere
+// yöneticisi, testler ve ölçüm programı aynı kodu kullanır.
+#include "layout.h"
+
+// count parça gap boşluklarıyla, her biri en az bir piksel olarak sığar mı
+static int layout_fits(int total, int count, int gap)
+{
+    return count <= 0 || total >= count + (count - 1) * gap;
+}
+
+// total uzunluğu count parçaya gap boşluklarıyla böl; index'inci parçanın
+// başlangıcını ve boyutunu döndür (artan pikseller ilk parçalara dağıtılır).
+// Boşluklar sığmıyorsa parçalar bir piksel kalacak kadar daraltılır.
+static void layout_split(int start, int total, int count, int gap, int index, int *pos, int *size)
+{
+    if (!layout_fits(total, count, gap))
+        gap = count > 1 && total > count ? (total - count) / (count - 1) : 0;
+
+    int usable = total - (count - 1) * gap;
+    int base = usable / count;
+    int extra = usable % count;
+
+    *pos = start + index * (base + gap) + (index < extra ? index : extra);
+    *size = base + (index < extra ? 1 : 0);
+}
+
+// Alanı dikey olarak count satıra böl
+static void layout_rows(Rect area, int count, int gap, Rect *out)
+{
+    for (int i = 0; i < count; i++)
+    {
+        out[i].x = area.x;
+        out[i].width = area.width;
+        layout_split(area.y, area.height, count, gap, i, &out[i].y, &out[i].height);
+    }
+}
+
+// Alanı yatay olarak count sütuna böl
+static void layout_columns(Rect area, int count, int gap, Rect *out)
+{
+    for (int i = 0; i < count; i++)
+    {
+        out[i].y = area.y;
+        out[i].height = area.height;
+        layout_split(area.x, area.width, count, gap, i, &out[i].x, &out[i].width);
+    }
+}
+
+// Sütun/satır düzenine sığmayan pencere sayılarında ızgaraya geçilir
+void layout_grid(Rect area, int count, const LayoutParams *params, Rect *out);
+
+// Ana/yığın ayrımı: ana bölge sayısını ve boyutunu hesapla
+static int layout_master_count(int count, const LayoutParams *params)
+{
+    int nmaster = params->nmaster < 0 ? 0 : params->nmaster;
+    return nmaster < count ? nmaster : count;
+}
+
+// Döşeli: solda ana sütun, sağda yığın sütunu
+void layout_tile(Rect area, int count, const LayoutParams *params, Rect *out)
+{
+    int nmaster = layout_master_count(count, params);
+    if (nmaster == 0 || nmaster == count)
+    {
+        if (!layout_fits(area.height, count, params->gap))
+            layout_grid(area, count, params, out);
+        else
+            layout_rows(area, count, params->gap, out);
+        return;
+    }
+
+    Rect master = area, stack = area;
+    master.width = (int)((area.width - params->gap) * (params->master_percent / 100.0));
+    stack.x = area.x + master.width + params->gap;
+    stack.width = area.width - master.width - params->gap;
+
+    if (!layout_fits(area.height, nmaster, params->gap) ||
+        !layout_fits(area.height, count - nmaster, params->gap))
+    {
+        layout_grid(area, count, params, out);
+        return;
+    }
+    layout_rows(master, nmaster, params->gap, out);
+    layout_rows(stack, count - nmaster, params->gap, out + nmaster);
+}
+
+// Alt yığın: üstte ana satır, altta yığın satırı
+void layout_bstack(Rect area, int count, const LayoutParams *params, Rect *out)
+{
+    int nmaster = layout_master_count(count, params);
+    if (nmaster == 0 || nmaster == count)
+    {
+        if (!layout_fits(area.width, count, params->gap))
+            layout_grid(area, count, params, out);
+        else
+            layout_columns(area, count, params->gap, out);
+        return;
+    }
+
+    Rect master = area, stack = area;
+    master.height = (int)((area.height - params->gap) * (params->master_percent / 100.0));
+    stack.y = area.y + master.height + params->gap;
+    stack.height = area.height - master.height - params->gap;
+
+    if (!layout_fits(area.width, nmaster, params->gap) ||
+        !layout_fits(area.width, count - nmaster, params->gap))
+    {
+        layout_grid(area, count, params, out);
+        return;
+    }
+    layout_columns(master, nmaster, params->gap, out);
+    layout_columns(stack, count - nmaster, params->gap, out + nmaster);
+}
+
+// Çok sütunlu yığın: ana sütunun yanındaki yığın, pencereler ince şeritlere
+// dönüşmesin diye yaklaşık kare sayıda sütuna bölünür
+void layout_multicolumn(Rect area, int count, const LayoutParams *params, Rect *out)
+{
+    int nmaster = layout_master_count(count, params);
+    int stack_count = count - nmaster;
+    Rect master = area, stack = area;
+
+    if (stack_count == 0)
+    {
+        if (!layout_fits(area.height, count, params->gap))
+            layout_grid(area, count, params, out);
+        else
+            layout_rows(area, count, params->gap, out);
+        return;
+    }
+    if (nmaster > 0)
+    {
+        master.width = (int)((area.width - params->gap) * (params->master_percent / 100.0));
+        stack.x = area.x + master.width + params->gap;
+        stack.width = area.width - master.width - params->gap;
+    }
+
+    // Sütun başına satır sayısı: ceil(sqrt(n))
+    int rows = 1;
+    while (rows * rows < stack_count)
+        rows++;
+    int columns = (stack_count + rows - 1) / rows;
+
+    if (!layout_fits(area.height, nmaster, params->gap) ||
+        !layout_fits(stack.height, rows, params->gap) ||
+        !layout_fits(stack.width, columns, params->gap))
+    {
+        layout_grid(area, count, params, out);
+        return;
+    }
+    if (nmaster > 0)
+        layout_rows(master, nmaster, params->gap, out);
+
+    for (int column = 0; column < columns; column++)
+    {
+        int first = column * rows;
+        int in_column = stack_count - first < rows ? stack_count - first : rows;
+        Rect strip = stack;
+        layout_split(stack.x, stack.width, columns, params->gap, column, &strip.x, &strip.width);
+        layout_rows(strip, in_column, params->gap, out + nmaster + first);
+    }
+}
+
+// Izgara boyutları: yaklaşık kare, sütun sayısı ceil(sqrt(count))
+static void layout_grid_size(int count, int *columns, int *rows)
+{
+    *columns = 1;
+    while (*columns * *columns < count)
+        (*columns)++;
+    *rows = (count + *columns - 1) / *columns;
+}
+
+// count pencerelik ızgara alana boş hücre bırakmadan sığar mı
+static int layout_grid_fits(Rect area, int count, int gap)
+{
+    int columns, rows;
+    layout_grid_size(count, &columns, &rows);
+    return area.width >= columns + (columns - 1) * gap &&
+           area.height >= rows + (rows - 1) * gap;
+}
+
+// Izgara: yaklaşık kare hücreler, son satır kalan genişliği paylaşır
+void layout_grid(Rect area, int count, const LayoutParams *params, Rect *out)
+{
+    int columns, rows;
+    layout_grid_size(count, &columns, &rows);
+
+    for (int row = 0; row < rows; row++)
+    {
+        int first = row * columns;
+        int in_row = count - first < columns ? count - first : columns;
+        Rect strip = area;
+        layout_split(area.y, area.height, rows, params->gap, row, &strip.y, &strip.height);
+        layout_columns(strip, in_row, params->gap, out + first);
+    }
+}
+
+// Tek pencere: hepsi çalışma alanını kaplar, odaktaki en üstte kalır
+void layout_monocle(Rect area, int count, const LayoutParams *params, Rect *out)
+{
+    (void)params;
+
+    for (int i = 0; i < count; i++)
+    {
+        out[i] = area;
+    }
+}
+
+// Sarmal: her pencere kalan alanın bir yarısını alır, yön saat yönünde döner.
+// Yarılama kalan pencerelere yer bırakmayacak kadar küçülünce kalanlar
+// son alana ızgara olarak dizilir.
+void layout_spiral(Rect area, int count, const LayoutParams *params, Rect *out)
+{
+    Rect rest = area;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (i == count - 1)
+        {
+            out[i] = rest;
+            break;
+        }
+
+        // İlk bölme ana bölge oranını, sonrakiler yarıyı kullanır
+        float ratio = i == 0 ? params->master_percent / 100.0 : 0.5;
+        Rect before = rest;
+        Rect piece = rest;
+        if (i % 2 == 0)
+        {
+            piece.width = (int)((rest.width - params->gap) * ratio);
+            rest.width -= piece.width + params->gap;
+            if (i % 4 == 0)
+                rest.x += piece.width + params->gap; // Sol parça
+            else
+                piece.x = rest.x + rest.width + params->gap; // Sağ parça
+        }
+        else
+        {
+            piece.height = (int)((rest.height - params->gap) * ratio);
+            rest.height -= piece.height + params->gap;
+            if (i % 4 == 1)
+                rest.y += piece.height + params->gap; // Üst parça
+            else
+                piece.y = rest.y + rest.height + params->gap; // Alt parça
+        }
+
+        if (piece.width < 1 || piece.height < 1 ||
+            !layout_grid_fits(rest, count - i - 1, params->gap))
+        {
+            layout_grid(before, count - i, params, out + i);
+            return;
+        }
+        out[i] = piece;
+    }
+}
+
+// Alt + Space ile sırayla seçilen yerleşimler (ilki varsayılan)
+const Layout layouts[] = {
+    {"tile", layout_tile},
+    {"monocle", layout_monocle},
+    {"grid", layout_grid},
+    {"bstack", layout_bstack},
+    {"multicolumn", layout_multicolumn},
+    {"spiral", layout_spiral},
+};
+
+const int layout_count = sizeof(layouts) / sizeof(layouts[0]);
@@ -0,0 +1,39 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+// Yerleşimler: istemci sayısı ve çalışma alanından hedef dikdörtgenleri
+// hesaplayan saf fonksiyonlardır; X'e veya global değişkenlere dokunmazlar.
+// Sonucun X'e uygulanması rearrange_windows() içinde ayrı bir adımdır.
+typedef struct
+{
+    int x, y, width, height;
+} Rect;
+
+typedef struct
+{
+    float master_percent; // Ana bölge oranı (yüzde)
+    int nmaster;          // Ana bölgedeki pencere sayısı
+    int gap;              // Pencereler arası boşluk
+} LayoutParams;
+
+// out dizisi en az count elemanlı olmalıdır
+typedef void (*LayoutFunc)(Rect area, int count, const LayoutParams *params, Rect *out);
+
+typedef struct
+{
+    const char *name;
+    LayoutFunc arrange;
+} Layout;
+
+void layout_tile(Rect area, int count, const LayoutParams *params, Rect *out);
+void layout_bstack(Rect area, int count, const LayoutParams *params, Rect *out);
+void layout_multicolumn(Rect area, int count, const LayoutParams *params, Rect *out);
+void layout_grid(Rect area, int count, const LayoutParams *params, Rect *out);
+void layout_monocle(Rect area, int count, const LayoutParams *params, Rect *out);
+void layout_spiral(Rect area, int count, const LayoutParams *params, Rect *out);
+
+// Alt + Space ile sırayla seçilen yerleşimler (ilki varsayılan)
+extern const Layout layouts[];
+extern const int layout_count;
+
+#endif
@@ -0,0 +1,50 @@
+// Yerleşim hesabının pencere başına maliyetini ölçer (make bench).
+// X sunucusu gerekmez; 1-10000 sentetik istemci kullanılır.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "layout.h"
+
+#define MAX_CLIENTS 10000
+
+static double now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main()
+{
+    static Rect out[MAX_CLIENTS];
+    int counts[] = {1, 10, 100, 1000, 10000};
+    Rect area = {0, 0, 1920, 1080};
+    LayoutParams params = {50.0, 1, 10};
+    volatile int sink = 0; // Derleyicinin hesabı atmasını engelle
+
+    printf("%-12s", "yerleşim");
+    for (unsigned c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+        printf(" %9d", counts[c]);
+    printf("   (ns/pencere)\n");
+
+    for (int l = 0; l < layout_count; l++)
+    {
+        printf("%-12s", layouts[l].name);
+        for (unsigned c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+        {
+            int n = counts[c];
+            // Her ölçüm yaklaşık aynı sayıda pencere işler
+            int rounds = 2000000 / n;
+            double start = now_ns();
+            for (int r = 0; r < rounds; r++)
+            {
+                layouts[l].arrange(area, n, &params, out);
+                sink += out[n - 1].x;
+            }
+            double elapsed = now_ns() - start;
+            printf(" %9.2f", elapsed / ((double)rounds * n));
+        }
+        printf("\n");
+    }
+    return sink == 42 ? 1 : 0;
+}
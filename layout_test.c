@@ -0,0 +1,92 @@
+// Yerleşim değişmezlerini X sunucusu olmadan doğrular (make test):
+// dikdörtgenler çalışma alanının içinde kalır, üst üste binmez ve
+// aralarında en az gap kadar boşluk bulunur. Sütunlara sığmayan yüzlerce
+// pencerede de (ızgaraya geçiş) geçerlidir.
+#include <stdio.h>
+#include <stdlib.h>
+#include "layout.h"
+
+#define MAX_CLIENTS 1000
+
+static int failures = 0;
+
+static void fail(const char *layout, int count, const char *what, int i, int j)
+{
+    fprintf(stderr, "HATA: %s n=%d: %s (%d, %d)\n", layout, count, what, i, j);
+    failures++;
+}
+
+// a'nın sağına ve altına gap eklendiğinde b ile kesişiyor mu
+static int too_close(const Rect *a, const Rect *b, int gap)
+{
+    return a->x < b->x + b->width + gap && b->x < a->x + a->width + gap &&
+           a->y < b->y + b->height + gap && b->y < a->y + a->height + gap;
+}
+
+static void check(const Layout *layout, Rect area, int count, const LayoutParams *params)
+{
+    static Rect out[MAX_CLIENTS];
+    layout->arrange(area, count, params, out);
+
+    for (int i = 0; i < count; i++)
+    {
+        const Rect *r = &out[i];
+        if (r->width <= 0 || r->height <= 0)
+            fail(layout->name, count, "boş dikdörtgen", i, i);
+        if (r->x < area.x || r->y < area.y ||
+            r->x + r->width > area.x + area.width ||
+            r->y + r->height > area.y + area.height)
+            fail(layout->name, count, "çalışma alanı dışında", i, i);
+
+        // Tek pencere yerleşiminde hepsi aynı alanı paylaşır
+        if (layout->arrange == layout_monocle)
+            continue;
+
+        for (int j = 0; j < i; j++)
+        {
+            if (too_close(r, &out[j], params->gap))
+                fail(layout->name, count, "üst üste binme veya eksik boşluk", j, i);
+        }
+    }
+}
+
+// Küçük sayılar tek tek, büyükler (ikili kontrol O(n^2)) seyrek denenir
+static int next_count(int n)
+{
+    if (n < 64)
+        return n + 1;
+    if (n < 300)
+        return n + 7;
+    return n * 3 / 2 < MAX_CLIENTS || n == MAX_CLIENTS ? n * 3 / 2 : MAX_CLIENTS;
+}
+
+int main()
+{
+    Rect areas[] = {
+        {0, 0, 1920, 1080},
+        {10, 35, 1900, 1035}, // Üstte bar, dış boşluk
+        {1920, 0, 1280, 1024}, // İkinci ekran
+    };
+    int gaps[] = {0, 1, 10};
+    float percents[] = {10.0, 50.0, 90.0};
+    int nmasters[] = {0, 1, 3};
+
+    for (int l = 0; l < layout_count; l++)
+        for (unsigned a = 0; a < sizeof(areas) / sizeof(areas[0]); a++)
+            for (unsigned g = 0; g < sizeof(gaps) / sizeof(gaps[0]); g++)
+                for (unsigned p = 0; p < sizeof(percents) / sizeof(percents[0]); p++)
+                    for (unsigned m = 0; m < sizeof(nmasters) / sizeof(nmasters[0]); m++)
+                        for (int n = 1; n <= MAX_CLIENTS; n = next_count(n))
+                        {
+                            LayoutParams params = {percents[p], nmasters[m], gaps[g]};
+                            check(&layouts[l], areas[a], n, &params);
+                        }
+
+    if (failures)
+    {
+        fprintf(stderr, "%d hata\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("layout_test: %d yerleşim, tüm değişmezler sağlandı\n", layout_count);
+    return EXIT_SUCCESS;
+}
@@ -8,13 +8,25 @@
 #include <unistd.h>
 #include <sys/wait.h>
 #include <string.h>   // memset fonksiyonu için gerekli
-#include <sys/time.h> // gettimeofday için
+#include <limits.h>   // LONG_MAX (kenarın tamamını kaplayan strut) için
+#include <stdarg.h>   // log_write için
+#include <poll.h>        // Olay döngüsü için
+#include <signal.h>      // SIGUSR1 ile istatistik dökümü için
+#include <time.h>        // clock_gettime için
+#include <sys/timerfd.h> // Zamanlayıcılar için
+#include <sys/signalfd.h>
 #include <X11/Xatom.h>
 #include <X11/Xutil.h>
+#include <X11/Xproto.h>
+#include <X11/extensions/sync.h> // _NET_WM_SYNC_REQUEST sayaçları için
+#ifdef XRANDR
+#include <X11/extensions/Xrandr.h> // Çoklu ekran (çıkış) keşfi için
+#endif
+#include "layout.h"
 
 // Workspace sabitleri
-#define NUM_WORKSPACES 5
-#define MAX_WINDOWS 100
+#define NUM_WORKSPACES 5  // Başlangıçtaki workspace sayısı (MWM_WORKSPACES ile değişir)
+#define MAX_WORKSPACES 32  // _NET_NUMBER_OF_DESKTOPS ile izin verilen en fazla sayı
 #define BORDER_WIDTH 2 // Pencere kenarlık kalınlığı
 
 // Tiling modu sabitleri
@@ -22,7 +34,8 @@
 #define MODE_TILING 1   // Döşeli yerleşim
 
 // Sabitler
-#define MASTER_SIZE 0.5                                                                             // Ana bölgenin ekran genişliğinin oranı
+#define MASTER_SIZE 0.5                                                                             // Ana bölgenin çıkış genişliğinin oranı (başlangıç)
+#define NMASTER 1                                                                                   // Ana bölgedeki pencere sayısı (başlangıç)
 #define OUTER_GAP 10                                                                                // Ekran kenarlarıyla pencereler arası boşluk
 #define INNER_GAP 10                                                                                // Pencereler arası boşluk
 #define TERMINAL "alacritty"                                                                        // Terminal programı
@@ -33,12 +46,54 @@
 #define ACTIVE_WINDOW_BORDER_FG 0x4C7899
 #define WINDOW_BORDER_FG 0x000000
 #define MODKEY Mod1Mask
+#define DRAG_RATE_HZ 60 // Sürükleme/boyutlandırma güncelleme sınırı (0: sınırsız)
+#define FOCUS_DELAY 30  // Fareyle odakta pencere üzerinde beklenecek süre (ms, MWM_FOCUS_DELAY)
+#define OUTLINE_DRAG 0  // 1: tüm workspace'lerde çerçeveyle sürükleme (MWM_OUTLINE, Alt + o)
+
+// Gizli workspace pencerelerinin saklanma biçimi (MWM_HIDE=unmap|park ile değişir).
+// Unmap istemciyi görünmez yapar ama ağır uygulamalar gösterilince baştan
+// çizer; park pencereyi eşlenmiş bırakıp ekran dışına taşır.
+#define HIDE_UNMAP 0
+#define HIDE_PARK 1
+#define HIDE_STRATEGY HIDE_UNMAP
+#define PARK_X -32000        // Park edilen pencerelerin x konumu (hiçbir çıkışta değil)
+#define SWITCH_GRAB_SERVER 0 // 1: workspace değişimi sunucu kilidi içinde yapılır (MWM_SWITCH_GRAB)
+#define SYNC_TIMEOUT 1000    // Boyutlandırma onayı gelmeyen istemci için bekleme sınırı (ms)
+
+// Günlük (log) seviyeleri. Derleme zamanı seviyesinin (LOG_LEVEL) üstündeki
+// çağrılar koddan tamamen çıkar; çalışma zamanı seviyesi MWM_LOG_LEVEL ile
+// düşürülebilir. Kayıtlar bellekteki halka tampona yazılır.
+#define LOG_ERROR 0
+#define LOG_WARN 1
+#define LOG_INFO 2
+#define LOG_DEBUG 3
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_INFO
+#endif
+#ifndef LOG_RING_SIZE
+#define LOG_RING_SIZE 1024 // Halka tampondaki kayıt sayısı
+#endif
+#define LOG_RECORD_SIZE 128      // Tek kaydın en fazla uzunluğu
+#define LOG_FLUSH_INTERVAL 1000 // Halka tamponun çıktıya yazılma aralığı (ms)
+
+#define LOG(level, ...)                                      \
+    do                                                       \
+    {                                                        \
+        if ((level) <= LOG_LEVEL && (level) <= log_level)    \
+            log_write((level), __VA_ARGS__);                 \
+    } while (0)
 
 // Bar sabitleri
+// Strut bildirmeyen dock'lar için ayrılacak alan (strut bildirenlerde kullanılmaz)
 #define BAR_HEIGHT 30      // Bar yüksekliği
 #define BAR_POSITION_TOP 1 // 1: üstte, 0: altta
 
+// Yönetilen pencere kaydı (tanımı aşağıda)
+typedef struct Client Client;
+
 // Fonksiyon prototipleri
+void log_write(int level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
 void focus_window(Window window);
 void handle_map_request(XMapRequestEvent *event);
 void handle_button_press(XButtonEvent *event);
@@ -48,7 +103,10 @@ void start_move(XButtonEvent *event);
 void start_resize(XButtonEvent *event);
 void handle_motion(XMotionEvent *event);
 void stop_drag(XButtonEvent *event);
-void rearrange_windows();
+void rearrange_windows(int workspace);
+void mark_layout_dirty(int workspace);
+void mark_monitor_layouts_dirty(int monitor);
+void mark_all_layouts_dirty();
 void update_screen_dimensions();
 void toggle_tiling_mode();
 void adjust_master_size(float delta_percent);
@@ -58,11 +116,29 @@ void adjust_gaps(int outer_delta, int inner_delta);
 void focus_next_window();
 void create_notification_window();
 void show_workspace_notification(int workspace_num);
-void check_notification_timeout();
+void hide_workspace_notification();
+void draw_workspace_notification();
 void init_atoms();
 void update_workspace_properties();
-void handle_strut_properties(Window window);
+void update_workarea();
 void move_window_to_workspace(Window window, int from_ws, int to_ws);
+void remove_window_from_workspace(Window w, int workspace);
+void client_list_append(Client *c);
+void client_list_remove(Client *c);
+void stack_raise(Client *c);
+void stack_lower(Client *c);
+void set_workspace_count(int count);
+int workspace_visible(int workspace);
+void resize_workspaces(int count);
+void focus_monitor(int delta);
+void client_forget_geometry(Window w);
+void client_hide(Client *c);
+void client_show(Client *c);
+void monitor_show_workspace(int monitor, int workspace);
+void finish_switch_measurement();
+void focus_last_in_workspace(int workspace);
+void clear_focus();
+void end_focus_cycle();
 
 // Fare ile sürükleme işlemi için gerekli değişkenler
 static int start_x, start_y;          // Sürükleme başlangıç koordinatları
@@ -70,31 +146,355 @@ static int orig_x, orig_y;            // Pencere orijinal koordinatları
 static int orig_width, orig_height;   // Pencere orijinal boyutları
 static Window dragging_window = None; // Şu an sürüklenen pencere
 static int resize_mode = 0;           // 0: taşıma, 1: boyutlandırma
+static int drag_x, drag_y;            // Henüz uygulanmamış son fare konumu
+static int drag_pending = 0;          // Uygulanmamış hareket var mı
+static unsigned long drag_last_apply; // Son geometri güncellemesinin zamanı (ms)
+static int outline_mode = 0;          // Bu sürükleme çerçeveyle mi yapılıyor
+static int outline_drawn = 0;         // Kökte çizili bir çerçeve var mı
+static int outline_x, outline_y, outline_width, outline_height; // Çizili çerçeve
+int outline_drag_default = OUTLINE_DRAG; // Yeni workspace'lerin başlangıç değeri
+int drag_rate_hz = DRAG_RATE_HZ;      // Saniyedeki en fazla geometri güncellemesi
+int focus_delay_ms = FOCUS_DELAY;     // EnterNotify odak gecikmesi (0: hemen)
+static Window pending_focus = None;   // Gecikme dolunca odaklanacak pencere
+static int focus_cycling = 0;         // Alt + Tab döngüsü sürüyor (Alt bırakılınca biter)
+int hide_strategy = HIDE_STRATEGY;    // HIDE_UNMAP veya HIDE_PARK
+int switch_grab_server = SWITCH_GRAB_SERVER;
+static Window switch_reveal_window = None; // Değişimde en son gösterilen pencere
+static unsigned long switch_start_us;      // Bekleyen değişimin başlangıcı (µs)
 
 // Global değişkenler
+int log_level = LOG_LEVEL; // Çalışma zamanı günlük seviyesi
 Display *display;
 Window root;
 static Window focused_window = None;
 int window_mode = MODE_FLOATING; // Başlangıçta serbest mod
-int master_width;                // Ana bölge genişliği (piksel)
-int screen_width, screen_height; // Ekran boyutları
+int screen_width, screen_height; // Kök pencere (tüm çıkışlar) boyutları
 int outer_gap = OUTER_GAP;
 int inner_gap = INNER_GAP;
 int gaps_enabled = 1;             // Boşluklar varsayılan olarak açık
-float master_size_percent = 50.0; // Ana bölge genişliği yüzdesi (başlangıçta %50)
 int is_switching_workspace = 0;   // Workspace değişimi sırasında bayrak
+static int ewmh_dirty = 1;              // EWMH özellikleri yeniden yayınlanacak mı
+static int desktop_updates_pending = 0; // _NET_WM_DESKTOP'u değişen pencere var mı
+static int stacking_dirty = 1;          // _NET_CLIENT_LIST_STACKING yeniden yazılacak mı
+static int workarea_dirty = 1;          // _NET_WORKAREA yeniden hesaplanacak mı
+static int screen_change_pending = 0;   // Ekran/çıkış değişikliği işlenecek mi
+#ifdef XRANDR
+static int randr_event_base = -1;       // RRScreenChangeNotify olay numarası tabanı
+#endif
+static int sync_event_base = -1;        // XSyncAlarmNotify olay numarası tabanı (-1: yok)
+static int xkb_event_base = -1;         // XkbStateNotify (Alt bırakma) olay numarası (-1: yok)
+
+// Yönetilen pencere (istemci) kaydı
+struct Client
+{
+    Window window;
+    int workspace;              // Bulunduğu workspace (-1: hiçbiri, örn. bar)
+    struct Client *prev, *next; // Workspace listesindeki komşular
+    struct Client *focus_prev, *focus_next; // Workspace odak geçmişi (MRU) komşuları
+    struct Client *stack_below, *stack_above; // Yığın (stacking) sırasındaki komşular
+    struct Client *dock_next;                 // Dock listesindeki sonraki
+    int is_dock;                              // Bar/dock olarak yönetiliyor mu
+    int dock_mapped;                          // Dock şu an görünür mü
+
+    // Önbellekteki özellikler: yönetime alınırken bir kez okunur, yalnızca
+    // ilgili PropertyNotify geldiğinde yenilenir
+    Atom window_type;       // _NET_WM_WINDOW_TYPE (ilk değer)
+    int is_dialog;          // Dialog tipi veya WM_TRANSIENT_FOR'u var (serbest kalır)
+    char *class_name;       // WM_CLASS res_class (yoksa NULL)
+    Window transient_for;   // WM_TRANSIENT_FOR
+    XSizeHints size_hints;  // WM_NORMAL_HINTS (flags == 0: yok)
+    long strut[12];         // _NET_WM_STRUT_PARTIAL biçiminde
+    int has_strut;
+
+    // EWMH gölge durumu
+    int published_desktop;  // Son yazılan _NET_WM_DESKTOP (-1: yazılmadı)
+    int listed;             // _NET_CLIENT_LIST gölgesinde mi
+
+    // Son uygulanan geometri: aynı dikdörtgen için istek gönderilmez
+    int geom_x, geom_y, geom_width, geom_height;
+    int geom_known;         // 0: pencere başka yoldan taşınmış olabilir
+
+    int x, y;               // Bilinen son konum (ConfigureNotify ve yerleşimden)
+    int width, height;      // Bilinen son boyut (sürükleme başlangıcı buradan okur)
+    int hidden;             // Gizli workspace'te (unmap veya park edilmiş)
+
+    // _NET_WM_SYNC_REQUEST: istemci yeni boyutu çizince sayacı günceller.
+    // Onay gelene kadar yeni geometri gönderilmez, yalnızca sonuncusu saklanır.
+    XSyncCounter sync_counter;  // None: istemci protokolü desteklemiyor
+    XSyncAlarm sync_alarm;      // Sayaç beklenen değere ulaşınca haber verir
+    XSyncValue sync_value;      // Son istenen sayaç değeri
+    int sync_waiting;           // Son boyutlandırma henüz onaylanmadı
+    struct Client *sync_prev, *sync_next; // Onay bekleyenler listesindeki komşular
+    unsigned long sync_sent;    // Onay beklemeye başlanan zaman (ms)
+    int sync_held;              // Bekletilen geometri var mı
+    int held_x, held_y, held_width, held_height;
+};
 
 // Workspace yapısı
 typedef struct
 {
-    Window windows[MAX_WINDOWS]; // Bu workspace'teki pencereler
-    int window_count;            // Pencere sayısı
-    int mode;                    // Bu workspace'in modu (MODE_FLOATING veya MODE_TILING)
+    Client *head, *tail; // Bu workspace'teki pencereler (sıralı, çift bağlı liste)
+    Client *focus_head, *focus_tail; // Odak geçmişi: baş en son odaklanan
+    int window_count;    // Pencere sayısı
+    int mode;            // Bu workspace'in modu (MODE_FLOATING veya MODE_TILING)
+    int layout_dirty;    // Yerleşim güncel değil (gizliyse gösterilince düzenlenir)
+    int layout;          // Döşeli modda kullanılan yerleşim (layouts[] indeksi)
+    int nmaster;         // Ana bölgedeki pencere sayısı
+    int monitor;         // Gösterildiği (gizliyse en son gösterildiği) çıkış
+    int outline_drag;    // Sürüklemede pencere yerine çerçeve çizilir
 } Workspace;
 
-// Global workspace değişkenleri
-Workspace workspaces[NUM_WORKSPACES];
-int current_workspace = 0; // Aktif workspace (0-8)
+// Global workspace değişkenleri (sayı çalışırken değişebilir)
+Workspace *workspaces = NULL;
+int num_workspaces = 0;
+int current_workspace = 0; // Aktif workspace (seçili çıkışta görünen)
+
+// Çıkış (monitör): her biri kendi workspace'ini, çalışma alanını ve ana
+// bölge oranını taşır. Bir çıkıştaki yerleşim diğerlerine dokunmaz.
+typedef struct
+{
+    int x, y, width, height;       // Kök pencere koordinatlarında çıkış
+    int wx, wy, wwidth, wheight;   // Dock'lardan sonra kalan çalışma alanı
+    int workspace;                 // Bu çıkışta görünen workspace
+    float master_percent;          // Ana bölge genişliği yüzdesi
+} Monitor;
+
+Monitor *monitors = NULL;
+int num_monitors = 0;
+int current_monitor = 0; // Odaktaki çıkış
+
+// Workspace şu an kendi çıkışında görünüyor mu
+int workspace_visible(int workspace)
+{
+    return workspace >= 0 && workspace < num_workspaces &&
+           monitors[workspaces[workspace].monitor].workspace == workspace;
+}
+
+// Tüm istemciler, Window kimliğine göre açık adresli (doğrusal sondalı) bir
+// karma tabloda tutulur. Arama, ekleme ve silme ortalama O(1)'dir.
+#define CLIENT_TABLE_MIN 64
+
+static Client **client_table = NULL; // NULL: boş yuva
+static unsigned long client_table_size = 0;
+static unsigned long client_count = 0;
+
+// Window kimliği için karma (Fibonacci çarpımı; XID'ler ardışık olduğundan)
+static unsigned long client_hash(Window w)
+{
+    return (unsigned long)((w * 11400714819323198485ULL) >> 20) & (client_table_size - 1);
+}
+
+// Tabloyu yeni boyuta taşı (boyut 2'nin kuvveti olmalı)
+static void client_table_resize(unsigned long new_size)
+{
+    Client **old_table = client_table;
+    unsigned long old_size = client_table_size;
+
+    client_table = calloc(new_size, sizeof(Client *));
+    if (!client_table)
+    {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+    client_table_size = new_size;
+
+    for (unsigned long i = 0; i < old_size; i++)
+    {
+        if (old_table[i])
+        {
+            unsigned long slot = client_hash(old_table[i]->window);
+            while (client_table[slot])
+                slot = (slot + 1) & (client_table_size - 1);
+            client_table[slot] = old_table[i];
+        }
+    }
+    free(old_table);
+}
+
+// Pencereye ait istemciyi bul (yönetilmiyorsa NULL)
+Client *client_find(Window w)
+{
+    if (client_count == 0 || w == None)
+        return NULL;
+
+    unsigned long slot = client_hash(w);
+    while (client_table[slot])
+    {
+        if (client_table[slot]->window == w)
+            return client_table[slot];
+        slot = (slot + 1) & (client_table_size - 1);
+    }
+    return NULL;
+}
+
+// Yeni istemci kaydı oluştur (varsa mevcut kaydı döndürür)
+Client *client_add(Window w)
+{
+    Client *c = client_find(w);
+    if (c)
+        return c;
+
+    // Yük oranını %50'nin altında tut
+    if (client_table_size == 0)
+        client_table_resize(CLIENT_TABLE_MIN);
+    else if ((client_count + 1) * 2 > client_table_size)
+        client_table_resize(client_table_size * 2);
+
+    c = calloc(1, sizeof(Client));
+    if (!c)
+    {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+    c->window = w;
+    c->workspace = -1;
+    c->published_desktop = -1;
+
+    unsigned long slot = client_hash(w);
+    while (client_table[slot])
+        slot = (slot + 1) & (client_table_size - 1);
+    client_table[slot] = c;
+    client_count++;
+    return c;
+}
+
+static Client *sync_waiting_head = NULL; // Boyutlandırma onayı bekleyen istemciler
+
+// İstemciyi onay bekleyenler listesine ekle veya çıkar. Alarm olayları ve
+// zaman aşımı yalnızca bu (çoğunlukla tek elemanlı) listeyi dolaşır.
+void client_set_sync_waiting(Client *c, int waiting)
+{
+    if (c->sync_waiting == waiting)
+        return;
+    c->sync_waiting = waiting;
+
+    if (waiting)
+    {
+        c->sync_prev = NULL;
+        c->sync_next = sync_waiting_head;
+        if (sync_waiting_head)
+            sync_waiting_head->sync_prev = c;
+        sync_waiting_head = c;
+        return;
+    }
+
+    if (c->sync_prev)
+        c->sync_prev->sync_next = c->sync_next;
+    else
+        sync_waiting_head = c->sync_next;
+    if (c->sync_next)
+        c->sync_next->sync_prev = c->sync_prev;
+    c->sync_prev = c->sync_next = NULL;
+}
+
+// İstemci kaydını sil. Doğrusal sondalama için mezar taşı yerine geriye
+// kaydırarak silinir, böylece aramalar uzamaz.
+void client_remove(Window w)
+{
+    if (client_count == 0)
+        return;
+
+    unsigned long mask = client_table_size - 1;
+    unsigned long slot = client_hash(w);
+    while (client_table[slot] && client_table[slot]->window != w)
+        slot = (slot + 1) & mask;
+    if (!client_table[slot])
+        return;
+
+    client_set_sync_waiting(client_table[slot], 0);
+    if (client_table[slot]->sync_alarm != None)
+        XSyncDestroyAlarm(display, client_table[slot]->sync_alarm);
+    free(client_table[slot]->class_name);
+    free(client_table[slot]);
+    client_table[slot] = NULL;
+    client_count--;
+
+    // Arkadaki kayıtları boşluğa doğru kaydır
+    unsigned long next = (slot + 1) & mask;
+    while (client_table[next])
+    {
+        unsigned long home = client_hash(client_table[next]->window);
+        // home, (slot, next] aralığında değilse kayıt boşluğa taşınabilir
+        if (((next - home) & mask) >= ((next - slot) & mask))
+        {
+            client_table[slot] = client_table[next];
+            client_table[next] = NULL;
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
+
+// İstemciyi workspace listesinden çıkar (O(1))
+void workspace_unlink(Workspace *ws, Client *c)
+{
+    if (c->prev)
+        c->prev->next = c->next;
+    else
+        ws->head = c->next;
+    if (c->next)
+        c->next->prev = c->prev;
+    else
+        ws->tail = c->prev;
+    c->prev = c->next = NULL;
+    ws->window_count--;
+}
+
+// İstemciyi listede before'un önüne ekle (before NULL ise sona)
+void workspace_insert_before(Workspace *ws, Client *c, Client *before)
+{
+    c->next = before;
+    c->prev = before ? before->prev : ws->tail;
+    if (c->prev)
+        c->prev->next = c;
+    else
+        ws->head = c;
+    if (before)
+        before->prev = c;
+    else
+        ws->tail = c;
+    ws->window_count++;
+}
+
+// İstemciyi odak geçmişinden çıkar (O(1))
+void focus_history_unlink(Workspace *ws, Client *c)
+{
+    if (c->focus_prev)
+        c->focus_prev->focus_next = c->focus_next;
+    else if (ws->focus_head == c)
+        ws->focus_head = c->focus_next;
+    if (c->focus_next)
+        c->focus_next->focus_prev = c->focus_prev;
+    else if (ws->focus_tail == c)
+        ws->focus_tail = c->focus_prev;
+    c->focus_prev = c->focus_next = NULL;
+}
+
+// İstemciyi odak geçmişinin başına (en son odaklanan) taşı (O(1))
+void focus_history_push(Workspace *ws, Client *c)
+{
+    if (ws->focus_head == c)
+        return;
+    focus_history_unlink(ws, c);
+    c->focus_next = ws->focus_head;
+    if (ws->focus_head)
+        ws->focus_head->focus_prev = c;
+    else
+        ws->focus_tail = c;
+    ws->focus_head = c;
+}
+
+// Hiç odaklanmamış istemciyi geçmişin sonuna ekle
+void focus_history_append(Workspace *ws, Client *c)
+{
+    c->focus_next = NULL;
+    c->focus_prev = ws->focus_tail;
+    if (ws->focus_tail)
+        ws->focus_tail->focus_next = c;
+    else
+        ws->focus_head = c;
+    ws->focus_tail = c;
+}
 
 // Tuş kodları için yapı tanımı
 typedef struct
@@ -134,6 +534,9 @@ typedef struct
     KeyCode up_key;
     KeyCode down_key;
     KeyCode tab_key;
+    KeyCode space_key;
+    KeyCode comma_key;
+    KeyCode period_key;
 } KeyBindings;
 
 // Global tuş kodları değişkeni
@@ -177,6 +580,9 @@ void init_keybindings()
     keys.up_key = XKeysymToKeycode(display, XK_Up);
     keys.down_key = XKeysymToKeycode(display, XK_Down);
     keys.tab_key = XKeysymToKeycode(display, XK_Tab);
+    keys.space_key = XKeysymToKeycode(display, XK_space);
+    keys.comma_key = XKeysymToKeycode(display, XK_comma);
+    keys.period_key = XKeysymToKeycode(display, XK_period);
 }
 
 // Tuş yakalama fonksiyonu
@@ -186,6 +592,12 @@ void grab_keys()
     XGrabKey(display, keys.d_key, MODKEY, root, True, GrabModeAsync, GrabModeAsync);
     XGrabKey(display, keys.q_key, MODKEY, root, True, GrabModeAsync, GrabModeAsync);
     XGrabKey(display, keys.t_key, MODKEY, root, True, GrabModeAsync, GrabModeAsync);
+    XGrabKey(display, keys.space_key, MODKEY, root, True, GrabModeAsync, GrabModeAsync);
+    XGrabKey(display, keys.comma_key, MODKEY, root, True, GrabModeAsync, GrabModeAsync);
+    XGrabKey(display, keys.period_key, MODKEY, root, True, GrabModeAsync, GrabModeAsync);
+    XGrabKey(display, keys.i_key, MODKEY, root, True, GrabModeAsync, GrabModeAsync);
+    XGrabKey(display, keys.u_key, MODKEY, root, True, GrabModeAsync, GrabModeAsync);
+    XGrabKey(display, keys.o_key, MODKEY, root, True, GrabModeAsync, GrabModeAsync);
     XGrabKey(display, keys.h_key, MODKEY, root, True, GrabModeAsync, GrabModeAsync);
     XGrabKey(display, keys.l_key, MODKEY, root, True, GrabModeAsync, GrabModeAsync);
     XGrabKey(display, keys.return_key, MODKEY, root, True, GrabModeAsync, GrabModeAsync);
@@ -235,21 +647,358 @@ void grab_keys()
 
 // Global değişken olarak ekle (diğer global değişkenlerin yanına)
 Cursor normal_cursor;
+Cursor move_cursor;   // Taşıma sırasında (başlangıçta bir kez oluşturulur)
+Cursor resize_cursor; // Boyutlandırma sırasında
+GC outline_gc;        // Sürükleme çerçevesi (XOR, başlangıçta bir kez oluşturulur)
+
+// NumLock'un bağlı olduğu değiştirici (klavye düzenine göre değişir)
+static unsigned int numlock_mask = 0;
+
+// NumLock maskesini değiştirici eşlemesinden bul (başlangıçta bir kez)
+void update_numlock_mask()
+{
+    XModifierKeymap *modmap = XGetModifierMapping(display);
+    KeyCode numlock = XKeysymToKeycode(display, XK_Num_Lock);
+
+    numlock_mask = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        for (int j = 0; j < modmap->max_keypermod; j++)
+        {
+            if (numlock && modmap->modifiermap[i * modmap->max_keypermod + j] == numlock)
+                numlock_mask = 1 << i;
+        }
+    }
+    XFreeModifiermap(modmap);
+}
+
+// Yönetilen pencereye Alt + sol/sağ tık yakalaması kur. Olay doğrudan
+// tıklanan istemciye gelir; sürükleme başlangıcında pencere aranmaz.
+// Kilit tuşları (CapsLock, NumLock) açıkken de çalışsın diye her
+// birleşim ayrıca yakalanır.
+void grab_client_buttons(Window window)
+{
+    unsigned int lock_masks[] = {0, LockMask, numlock_mask, LockMask | numlock_mask};
+    for (unsigned i = 0; i < sizeof(lock_masks) / sizeof(lock_masks[0]); i++)
+    {
+        XGrabButton(display, Button1, MODKEY | lock_masks[i], window, False,
+                    ButtonPressMask | ButtonReleaseMask | ButtonMotionMask,
+                    GrabModeAsync, GrabModeAsync, None, None);
+        XGrabButton(display, Button3, MODKEY | lock_masks[i], window, False,
+                    ButtonPressMask | ButtonReleaseMask | ButtonMotionMask,
+                    GrabModeAsync, GrabModeAsync, None, None);
+    }
+}
 
 // Bildirim penceresi için global değişkenler
 Window notification_window = None;
 int notification_timeout = 1000; // milisaniye cinsinden (1 saniye)
-unsigned long popup_timer = 0;   // Zamanlayıcı için
+// Bildirim çizim kaynakları: pencereyle birlikte bir kez oluşturulur
+XFontStruct *notification_font = NULL;
+GC notification_gc = NULL;
+Pixmap notification_digits = None; // Önceden çizilmiş numaralar (yan yana hücreler)
+int notification_cell_width, notification_cell_height;
+int notification_workspace = 0;    // Bildirimde gösterilen workspace
+int notification_width = 100, notification_height = 50; // Son gösterimdeki boyut
+
+// Zamanlayıcılar: hepsi tek bir timerfd üzerinden çalışır, en yakın süre kurulur
+typedef void (*TimerCallback)(void);
+
+typedef struct
+{
+    unsigned long deadline; // CLOCK_MONOTONIC milisaniye, 0: kapalı
+    TimerCallback callback;
+} Timer;
+
+enum
+{
+    TIMER_NOTIFICATION, // Workspace bildirim penceresi
+    TIMER_DRAG,         // Kare hızına bağlı sürükleme güncellemesi
+    TIMER_LOG_FLUSH,    // Günlük halka tamponunun çıktıya yazılması
+    TIMER_FOCUS,        // Fareyle odakta gecikmeli odak değişimi
+    TIMER_SYNC,         // Boyutlandırma onayı için zaman aşımı
+    NUM_TIMERS
+};
+
+static Timer timers[NUM_TIMERS];
+static int timer_fd = -1;
+static int signal_fd = -1;
+
+// Performans sayaçları (SIGUSR1 ile stderr'e yazdırılır)
+typedef struct
+{
+    unsigned long wakeups; // poll() dönüş sayısı
+    unsigned long events;  // İşlenen X olayı sayısı
+    unsigned long motion_coalesced; // Birleştirilip atlanan MotionNotify
+    unsigned long drag_updates;     // Sürüklemede gönderilen geometri isteği
+    unsigned long relayouts;         // Yapılan yerleşim hesabı
+    unsigned long relayouts_skipped; // Kirli bayrağı sayesinde atlanan yerleşim
+    unsigned long relayouts_deferred; // Gizliyken bayatlayan (gösterilene dek ertelenen) yerleşim
+    unsigned long configures_sent;   // Yerleşimde gönderilen geometri isteği
+    unsigned long configures_elided; // Geometri değişmediği için gönderilmeyen istek
+    unsigned long sync_requests;     // Gönderilen _NET_WM_SYNC_REQUEST
+    unsigned long sync_held;         // Onay beklenirken bekletilen (birleştirilen) geometri
+    unsigned long sync_timeouts;     // Onay gelmeden süresi dolan bekleme
+    unsigned long screen_events;     // Alınan ekran değişikliği olayı
+    unsigned long screen_changes;    // Yapılan çıkış/çalışma alanı yeniden hesabı
+    unsigned long focus_changes;     // Gerçekleşen odak değişimi
+    unsigned long focus_noops;       // Zaten odaktaki pencere için atlanan istek
+    unsigned long focus_debounced;   // Gecikme içinde yerini yenisine bırakan EnterNotify
+    unsigned long switches;          // Ölçülen workspace değişimi
+    unsigned long switch_us_total;   // Değişim gecikmelerinin toplamı (µs)
+    unsigned long switch_us_max;     // En uzun değişim gecikmesi (µs)
+    unsigned long switch_us_last;    // Son değişim gecikmesi (µs)
+    unsigned long ewmh_writes;       // Yazılan EWMH özelliği
+    unsigned long ewmh_suppressed;   // Değişmediği için yazılmayan EWMH özelliği
+    unsigned long syncs;             // Açık XSync gidiş-dönüşü
+    unsigned long syncs_last_second; // Son tamamlanan saniyedeki XSync sayısı
+    unsigned long syncs_this_second; // İçinde bulunulan saniyedeki XSync sayısı
+    unsigned long sync_second_start; // İçinde bulunulan saniyenin başlangıcı (ms)
+} Stats;
+
+static Stats stats;
+static unsigned long start_time_ms; // İstatistikler için başlangıç zamanı
+
+// Monoton saat (milisaniye)
+unsigned long now_ms()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Gecikme ölçümleri için mikrosaniye cinsinden monoton zaman
+unsigned long now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// timerfd'yi en yakın zamanlayıcıya göre yeniden kur
+void timer_rearm()
+{
+    unsigned long earliest = 0;
+    for (int i = 0; i < NUM_TIMERS; i++)
+    {
+        if (timers[i].deadline != 0 && (earliest == 0 || timers[i].deadline < earliest))
+        {
+            earliest = timers[i].deadline;
+        }
+    }
+
+    // Sıfır değer timerfd'yi durdurur; boşta hiç uyanma olmaz
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    if (earliest != 0)
+    {
+        spec.it_value.tv_sec = earliest / 1000;
+        spec.it_value.tv_nsec = (earliest % 1000) * 1000000;
+    }
+    timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, NULL);
+}
+
+// Zamanlayıcıyı delay_ms sonrasına kur (varsa öncekinin yerine geçer)
+void timer_schedule(int id, unsigned long delay_ms, TimerCallback callback)
+{
+    timers[id].deadline = now_ms() + (delay_ms ? delay_ms : 1);
+    timers[id].callback = callback;
+    timer_rearm();
+}
+
+// Zamanlayıcıyı iptal et
+void timer_cancel(int id)
+{
+    if (timers[id].deadline == 0)
+        return;
+    timers[id].deadline = 0;
+    timer_rearm();
+}
+
+// Süresi dolan zamanlayıcıları çalıştır
+void timer_dispatch()
+{
+    unsigned long long expirations;
+    if (read(timer_fd, &expirations, sizeof(expirations)) < 0)
+    {
+        // Saat geri alındıysa (ECANCELED) veya sahte uyanmada yine de kontrol et
+    }
+
+    unsigned long now = now_ms();
+    for (int i = 0; i < NUM_TIMERS; i++)
+    {
+        if (timers[i].deadline != 0 && timers[i].deadline <= now)
+        {
+            timers[i].deadline = 0;
+            timers[i].callback();
+        }
+    }
+    timer_rearm();
+}
+
+// Saniye başına XSync sayacını güncelle
+void roll_sync_counter(unsigned long now)
+{
+    if (now - stats.sync_second_start >= 1000)
+    {
+        // Aradan bir saniyeden fazla geçtiyse son saniye boştur
+        stats.syncs_last_second = now - stats.sync_second_start < 2000 ? stats.syncs_this_second : 0;
+        stats.syncs_this_second = 0;
+        stats.sync_second_start = now;
+    }
+}
+
+// Sunucuyla açık gidiş-dönüş. Olay işleyicilerinde kullanılmaz; istekler döngü
+// başına tek noktada (run_event_loop içindeki XFlush) gönderilir. Yalnızca
+// hata yakalama gibi yanıtın beklenmesi gereken yerlerde çağrılır.
+void wm_sync()
+{
+    unsigned long now = now_ms();
+    roll_sync_counter(now);
+    XSync(display, False);
+    stats.syncs++;
+    stats.syncs_this_second++;
+}
+
+// Sayaçları stderr'e yazdır
+void dump_stats()
+{
+    unsigned long now = now_ms();
+    unsigned long uptime = now - start_time_ms;
+    roll_sync_counter(now);
+
+    fprintf(stderr, "mwm istatistik: uyanma=%lu olay=%lu\n",
+            stats.wakeups, stats.events);
+    fprintf(stderr, "  sürükleme: birleştirilen hareket=%lu güncelleme=%lu\n",
+            stats.motion_coalesced, stats.drag_updates);
+    fprintf(stderr, "  yerleşim: yapılan=%lu atlanan=%lu ertelenen=%lu\n",
+            stats.relayouts, stats.relayouts_skipped, stats.relayouts_deferred);
+    fprintf(stderr, "  geometri: gönderilen=%lu atlanan=%lu\n",
+            stats.configures_sent, stats.configures_elided);
+    fprintf(stderr, "  senkron boyutlandırma: istek=%lu bekletilen=%lu zaman aşımı=%lu\n",
+            stats.sync_requests, stats.sync_held, stats.sync_timeouts);
+    fprintf(stderr, "  ekran değişikliği: olay=%lu hesap=%lu\n",
+            stats.screen_events, stats.screen_changes);
+    fprintf(stderr, "  odak: değişim=%lu atlanan=%lu ertelenip düşen=%lu\n",
+            stats.focus_changes, stats.focus_noops, stats.focus_debounced);
+    fprintf(stderr, "  workspace değişimi (%s%s): sayı=%lu son=%luµs ortalama=%luµs en uzun=%luµs\n",
+            hide_strategy == HIDE_PARK ? "park" : "unmap",
+            switch_grab_server ? ", kilitli" : "",
+            stats.switches, stats.switch_us_last,
+            stats.switches ? stats.switch_us_total / stats.switches : 0,
+            stats.switch_us_max);
+    fprintf(stderr, "  EWMH: yazılan=%lu bastırılan=%lu\n",
+            stats.ewmh_writes, stats.ewmh_suppressed);
+    fprintf(stderr, "  XSync: toplam=%lu son saniye=%lu ortalama=%.2f/sn\n",
+            stats.syncs, stats.syncs_last_second,
+            uptime ? stats.syncs * 1000.0 / uptime : 0.0);
+}
+
+// Günlük halka tamponu. Tek üretici (olay döngüsü) kayıt yazar ve yazma
+// sayacını release ile yayınlar; okuyucu acquire ile okur, kilit yoktur.
+// Tampon dolunca en eski kayıtların üzerine yazılır.
+typedef struct
+{
+    unsigned long time; // Başlangıçtan beri geçen ms
+    int level;
+    char text[LOG_RECORD_SIZE];
+} LogRecord;
+
+static LogRecord log_ring[LOG_RING_SIZE];
+static unsigned long log_head = 0;    // Yazılan toplam kayıt
+static unsigned long log_flushed = 0; // Çıktıya yazılan toplam kayıt
+static unsigned long log_dropped = 0; // Yazılamadan üzerine yazılan kayıt
+
+static const char *log_level_names[] = {"HATA", "UYARI", "BILGI", "DEBUG"};
+
+void log_flush();
+
+// Kaydı halka tampona yaz: sıcak yolda G/Ç ve bellek ayırma yoktur (yalnızca
+// zaman damgası için saat okunur)
+void log_write(int level, const char *fmt, ...)
+{
+    unsigned long head = __atomic_load_n(&log_head, __ATOMIC_RELAXED);
+    LogRecord *record = &log_ring[head % LOG_RING_SIZE];
+    va_list args;
+
+    record->time = now_ms() - start_time_ms;
+    record->level = level;
+    va_start(args, fmt);
+    vsnprintf(record->text, sizeof(record->text), fmt, args);
+    va_end(args);
+
+    __atomic_store_n(&log_head, head + 1, __ATOMIC_RELEASE);
+
+    // Çıktıya yazmayı olay döngüsüne bırak
+    if (timers[TIMER_LOG_FLUSH].deadline == 0 && timer_fd >= 0)
+    {
+        timer_schedule(TIMER_LOG_FLUSH, LOG_FLUSH_INTERVAL, log_flush);
+    }
+}
+
+// [from, to) aralığındaki kayıtları fd'ye toplu olarak yaz
+void log_write_range(int fd, unsigned long from, unsigned long to)
+{
+    char buffer[8192];
+    size_t used = 0;
+
+    for (unsigned long i = from; i < to; i++)
+    {
+        LogRecord *record = &log_ring[i % LOG_RING_SIZE];
+        char line[LOG_RECORD_SIZE + 32];
+        int len = snprintf(line, sizeof(line), "[%lu.%03lu] %s: %s\n",
+                           record->time / 1000, record->time % 1000,
+                           log_level_names[record->level], record->text);
+        if (len < 0)
+            continue;
+        if ((size_t)len >= sizeof(line))
+            len = sizeof(line) - 1;
+
+        if (used + len > sizeof(buffer))
+        {
+            if (write(fd, buffer, used) < 0)
+                return;
+            used = 0;
+        }
+        memcpy(buffer + used, line, len);
+        used += len;
+    }
+
+    if (used > 0 && write(fd, buffer, used) < 0)
+        return;
+}
+
+// Henüz yazılmamış kayıtları stdout'a yaz (zamanlayıcı tarafından çağrılır)
+void log_flush()
+{
+    unsigned long head = __atomic_load_n(&log_head, __ATOMIC_ACQUIRE);
+
+    // Tampon taştıysa kaybolan kayıtları atla
+    if (head - log_flushed > LOG_RING_SIZE)
+    {
+        log_dropped += head - log_flushed - LOG_RING_SIZE;
+        log_flushed = head - LOG_RING_SIZE;
+    }
+
+    log_write_range(STDOUT_FILENO, log_flushed, head);
+    log_flushed = head;
+}
+
+// Halka tamponun tamamını stderr'e dök (SIGUSR2)
+void log_dump()
+{
+    unsigned long head = __atomic_load_n(&log_head, __ATOMIC_ACQUIRE);
+    unsigned long from = head > LOG_RING_SIZE ? head - LOG_RING_SIZE : 0;
 
-// Bar için global değişkenler
-Window bar_window = None;
-int bar_exists = 0;
-int effective_screen_y;      // Bar'dan sonra başlayan ekran y koordinatı
-int effective_screen_height; // Bar'dan geriye kalan ekran yüksekliği
+    fprintf(stderr, "mwm günlük dökümü: %lu kayıt (%lu kayıp)\n",
+            head - from, log_dropped);
+    log_write_range(STDERR_FILENO, from, head);
+}
 
 // EWMH Atomları için global değişkenler
 Atom _NET_WM_WINDOW_TYPE;
 Atom _NET_WM_WINDOW_TYPE_DOCK;
+Atom _NET_WM_WINDOW_TYPE_DIALOG;
 Atom _NET_WM_DESKTOP;
 Atom _NET_CURRENT_DESKTOP;
 Atom _NET_NUMBER_OF_DESKTOPS;
@@ -260,6 +1009,50 @@ Atom _NET_WM_STRUT;
 Atom _NET_WM_STATE;
 Atom _NET_WM_STATE_DEMANDS_ATTENTION;
 Atom _NET_SUPPORTED;
+Atom _NET_CLIENT_LIST_STACKING;
+Atom _NET_WORKAREA;
+Atom _NET_DESKTOP_NAMES;
+Atom _NET_DESKTOP_VIEWPORT;
+Atom UTF8_STRING;
+Atom WM_PROTOCOLS;
+Atom WM_DELETE_WINDOW;
+Atom _NET_WM_SYNC_REQUEST;
+Atom _NET_WM_SYNC_REQUEST_COUNTER;
+
+// mwm'in kullandığı tüm atomlar: başlangıçta tek bir XInternAtoms isteğiyle
+// alınır, sıcak yollarda yalnızca yukarıdaki değişkenler okunur
+#define ATOM_ENTRY(name) {&name, #name}
+
+static const struct
+{
+    Atom *atom;
+    const char *name;
+} atom_table[] = {
+    ATOM_ENTRY(_NET_WM_WINDOW_TYPE),
+    ATOM_ENTRY(_NET_WM_WINDOW_TYPE_DOCK),
+    ATOM_ENTRY(_NET_WM_WINDOW_TYPE_DIALOG),
+    ATOM_ENTRY(_NET_WM_DESKTOP),
+    ATOM_ENTRY(_NET_CURRENT_DESKTOP),
+    ATOM_ENTRY(_NET_NUMBER_OF_DESKTOPS),
+    ATOM_ENTRY(_NET_CLIENT_LIST),
+    ATOM_ENTRY(_NET_ACTIVE_WINDOW),
+    ATOM_ENTRY(_NET_WM_STRUT_PARTIAL),
+    ATOM_ENTRY(_NET_WM_STRUT),
+    ATOM_ENTRY(_NET_WM_STATE),
+    ATOM_ENTRY(_NET_WM_STATE_DEMANDS_ATTENTION),
+    ATOM_ENTRY(_NET_SUPPORTED),
+    ATOM_ENTRY(_NET_CLIENT_LIST_STACKING),
+    ATOM_ENTRY(_NET_WORKAREA),
+    ATOM_ENTRY(_NET_DESKTOP_NAMES),
+    ATOM_ENTRY(_NET_DESKTOP_VIEWPORT),
+    ATOM_ENTRY(UTF8_STRING),
+    ATOM_ENTRY(WM_PROTOCOLS),
+    ATOM_ENTRY(WM_DELETE_WINDOW),
+    ATOM_ENTRY(_NET_WM_SYNC_REQUEST),
+    ATOM_ENTRY(_NET_WM_SYNC_REQUEST_COUNTER),
+};
+
+#define ATOM_COUNT (sizeof(atom_table) / sizeof(atom_table[0]))
 
 // Uygulama sınıfı ve workspace eşleştirmesi için yapı
 typedef struct
@@ -277,6 +1070,17 @@ AppWorkspaceMapping default_mappings[] = {
     {NULL, -1} // Son eleman
 };
 
+// Her sürükleme hareketinde yeniden çizimi pahalı olan uygulamalar: bunlar
+// çerçeveyle taşınır/boyutlandırılır, istemciye bırakınca tek istek gider
+const char *outline_classes[] = {
+    "firefox",
+    "Firefox",
+    "libreoffice-writer",
+    "libreoffice-calc",
+    "libreoffice-impress",
+    NULL // Son eleman
+};
+
 // Pencere sınıfını al
 char *get_window_class(Window window)
 {
@@ -293,139 +1097,535 @@ char *get_window_class(Window window)
     return class_name;
 }
 
-// Pencere için workspace numarasını bul
-int get_workspace_for_window(Window window)
+// Pencerenin _NET_WM_WINDOW_TYPE özelliğindeki ilk atomu oku
+Atom get_window_type(Window window)
 {
-    char *class_name = get_window_class(window);
-    if (!class_name)
-        return 4; // Tanımlanmamış sınıf için 5. workspace (index 4)
+    Atom actual_type;
+    int actual_format;
+    unsigned long nitems, bytes_after;
+    unsigned char *data = NULL;
+    Atom type = None;
 
-    // Eşleştirmeleri kontrol et
-    for (int i = 0; default_mappings[i].class_name != NULL; i++)
+    if (XGetWindowProperty(display, window, _NET_WM_WINDOW_TYPE,
+                           0, 1, False, XA_ATOM, &actual_type,
+                           &actual_format, &nitems, &bytes_after,
+                           &data) == Success &&
+        data)
     {
-        if (strcmp(class_name, default_mappings[i].class_name) == 0)
-        {
-            free(class_name);
-            return default_mappings[i].workspace;
-        }
+        if (nitems > 0)
+            type = *(Atom *)data;
+        XFree(data);
     }
-
-    free(class_name);
-    return 4; // Eşleşme bulunamadığında 5. workspace (index 4)
+    return type;
 }
 
-// Dialog penceresi kontrolü için fonksiyon
-int is_dialog_window(Window window)
+// Pencerenin strut değerlerini _NET_WM_STRUT_PARTIAL biçiminde oku
+int get_window_strut(Window window, long strut[12])
 {
     Atom actual_type;
     int actual_format;
     unsigned long nitems, bytes_after;
     unsigned char *data = NULL;
+    int found = 0;
 
-    Atom window_type = XInternAtom(display, "_NET_WM_WINDOW_TYPE", False);
-    Atom dialog_type = XInternAtom(display, "_NET_WM_WINDOW_TYPE_DIALOG", False);
+    memset(strut, 0, 12 * sizeof(long));
 
-    if (XGetWindowProperty(display, window, window_type,
-                           0, 1, False, XA_ATOM, &actual_type,
+    // Önce _NET_WM_STRUT_PARTIAL'ı kontrol et
+    if (XGetWindowProperty(display, window, _NET_WM_STRUT_PARTIAL,
+                           0, 12, False, XA_CARDINAL, &actual_type,
                            &actual_format, &nitems, &bytes_after,
                            &data) == Success &&
         data)
     {
-        Atom type = *(Atom *)data;
+        if (nitems == 12)
+        {
+            memcpy(strut, data, 12 * sizeof(long));
+            found = 1;
+        }
         XFree(data);
-        if (type == dialog_type)
+        data = NULL;
+    }
+
+    // Sonra _NET_WM_STRUT'u kontrol et (kenarın tamamını kaplar)
+    if (!found &&
+        XGetWindowProperty(display, window, _NET_WM_STRUT,
+                           0, 4, False, XA_CARDINAL, &actual_type,
+                           &actual_format, &nitems, &bytes_after,
+                           &data) == Success &&
+        data)
+    {
+        if (nitems == 4)
         {
-            return 1;
+            long *values = (long *)data;
+            for (int i = 0; i < 4; i++)
+                strut[i] = values[i];
+            // Kenarın tamamı: bitişler ekran boyutuna bağlanmaz, RandR ile
+            // ekran büyüse de strut yeni kenarın tamamını kaplamaya devam eder
+            strut[5] = strut[7] = LONG_MAX;  // left/right_end_y
+            strut[9] = strut[11] = LONG_MAX; // top/bottom_end_x
+            found = 1;
         }
+        XFree(data);
     }
-    return 0;
+    return found;
 }
 
-// Pencere tipini kontrol et
-int is_bar_window(Window window)
+// İstemci WM_PROTOCOLS'te _NET_WM_SYNC_REQUEST bildiriyorsa sayacını ve
+// ona bağlı alarmı hazırla; bildirmiyorsa senkronizasyonu kapat
+void client_update_sync(Client *c)
 {
-    XWindowAttributes attrs;
-    XGetWindowAttributes(display, window, &attrs);
+    XSyncCounter counter = None;
+
+    Atom *protocols = NULL;
+    int count = 0;
+    int supported = 0;
+    if (sync_event_base >= 0 && XGetWMProtocols(display, c->window, &protocols, &count))
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (protocols[i] == _NET_WM_SYNC_REQUEST)
+                supported = 1;
+        }
+        XFree(protocols);
+    }
 
-    // _NET_WM_WINDOW_TYPE atomunu al
     Atom actual_type;
     int actual_format;
     unsigned long nitems, bytes_after;
     unsigned char *data = NULL;
-    Atom window_type_atom = XInternAtom(display, "_NET_WM_WINDOW_TYPE", False);
-    Atom dock_atom = XInternAtom(display, "_NET_WM_WINDOW_TYPE_DOCK", False);
-
-    if (XGetWindowProperty(display, window, window_type_atom,
-                           0, 1, False, XA_ATOM, &actual_type,
+    if (supported &&
+        XGetWindowProperty(display, c->window, _NET_WM_SYNC_REQUEST_COUNTER,
+                           0, 1, False, XA_CARDINAL, &actual_type,
                            &actual_format, &nitems, &bytes_after,
                            &data) == Success &&
         data)
     {
-        Atom type = *(Atom *)data;
+        if (nitems == 1)
+            counter = ((unsigned long *)data)[0];
         XFree(data);
-        if (type == dock_atom)
-        {
-            return 1;
-        }
     }
 
-    // Pencere ismini kontrol et (polybar veya lemonbar için)
-    XClassHint class_hint;
-    if (XGetClassHint(display, window, &class_hint))
+    if (counter == c->sync_counter)
+        return;
+
+    if (c->sync_alarm != None)
     {
-        int is_bar = (strcmp(class_hint.res_class, "Polybar") == 0 ||
-                      strcmp(class_hint.res_class, "lemonbar") == 0);
-        XFree(class_hint.res_name);
-        XFree(class_hint.res_class);
-        return is_bar;
+        XSyncDestroyAlarm(display, c->sync_alarm);
+        c->sync_alarm = None;
     }
+    c->sync_counter = None;
+    client_set_sync_waiting(c, 0);
+    if (counter == None)
+        return;
 
-    return 0;
+    // Sayaç istemcinindir, yalnızca istemci yazar (EWMH). İstekler onun şu
+    // anki değerinden başlayarak birer artırılır.
+    if (!XSyncQueryCounter(display, counter, &c->sync_value))
+        return;
+    c->sync_counter = counter;
+
+    XSyncAlarmAttributes attrs;
+    attrs.trigger.counter = counter;
+    attrs.trigger.value_type = XSyncAbsolute;
+    attrs.trigger.test_type = XSyncPositiveComparison;
+    XSyncValue one;
+    int overflow;
+    XSyncIntToValue(&one, 1);
+    XSyncValueAdd(&attrs.trigger.wait_value, c->sync_value, one, &overflow);
+    XSyncIntToValue(&attrs.delta, 0);
+    attrs.events = True;
+    c->sync_alarm = XSyncCreateAlarm(display,
+                                     XSyncCACounter | XSyncCAValueType | XSyncCATestType |
+                                         XSyncCAValue | XSyncCADelta | XSyncCAEvents,
+                                     &attrs);
+    LOG(LOG_DEBUG, "Pencere %ld senkron boyutlandırma destekliyor", c->window);
 }
 
-// Ekran boyutlarını bar'a göre güncelle
-void update_screen_dimensions_with_bar()
+// İstemcinin önbellekteki özelliklerini sunucudan yenile.
+// property None ise hepsi okunur (yönetime alınırken).
+void client_update_properties(Client *c, Atom property)
 {
-    Screen *screen = DefaultScreenOfDisplay(display);
-    screen_width = WidthOfScreen(screen);
-    screen_height = HeightOfScreen(screen);
+    if (property == None || property == _NET_WM_WINDOW_TYPE)
+    {
+        c->window_type = get_window_type(c->window);
+    }
 
-    if (bar_exists)
+    if (property == None || property == XA_WM_CLASS)
     {
-        if (BAR_POSITION_TOP)
-        {
-            effective_screen_y = BAR_HEIGHT;
-            effective_screen_height = screen_height - BAR_HEIGHT;
-        }
-        else
-        {
-            effective_screen_y = 0;
-            effective_screen_height = screen_height - BAR_HEIGHT;
-        }
+        free(c->class_name);
+        c->class_name = get_window_class(c->window);
     }
-    else
+
+    if (property == None || property == XA_WM_TRANSIENT_FOR)
     {
-        effective_screen_y = 0;
-        effective_screen_height = screen_height;
+        Window transient_for = None;
+        if (!XGetTransientForHint(display, c->window, &transient_for))
+            transient_for = None;
+        c->transient_for = transient_for;
     }
 
-    // Ana bölge genişliğini yüzdeye göre güncelle
-    master_width = (int)((float)screen_width * (master_size_percent / 100.0));
-}
+    // Başka bir pencereye bağlı (geçici) pencereler de dialog gibi döşenmez
+    c->is_dialog = c->window_type == _NET_WM_WINDOW_TYPE_DIALOG || c->transient_for != None;
 
-// Tiling moduna geç
+    if (property == None || property == XA_WM_NORMAL_HINTS)
+    {
+        long supplied;
+        if (!XGetWMNormalHints(display, c->window, &c->size_hints, &supplied))
+            c->size_hints.flags = 0;
+    }
+
+    if (property == None || property == _NET_WM_STRUT_PARTIAL || property == _NET_WM_STRUT)
+    {
+        c->has_strut = get_window_strut(c->window, c->strut);
+    }
+
+    if (property == None || property == WM_PROTOCOLS || property == _NET_WM_SYNC_REQUEST_COUNTER)
+    {
+        client_update_sync(c);
+    }
+}
+
+// Pencere için workspace numarasını bul (önbellekteki sınıf adından)
+int get_workspace_for_window(Window window)
+{
+    Client *c = client_find(window);
+    int fallback = num_workspaces > 4 ? 4 : num_workspaces - 1;
+    if (!c || !c->class_name)
+        return fallback; // Tanımlanmamış sınıf için 5. workspace (index 4)
+
+    // Eşleştirmeleri kontrol et
+    for (int i = 0; default_mappings[i].class_name != NULL; i++)
+    {
+        if (strcmp(c->class_name, default_mappings[i].class_name) == 0)
+        {
+            return default_mappings[i].workspace < num_workspaces ? default_mappings[i].workspace : num_workspaces - 1;
+        }
+    }
+
+    return fallback; // Eşleşme bulunamadığında 5. workspace (index 4)
+}
+
+// Dialog penceresi kontrolü için fonksiyon (sunucuya sormaz)
+int is_dialog_window(Window window)
+{
+    Client *c = client_find(window);
+    return c && c->is_dialog;
+}
+
+// Pencere tipini kontrol et (sunucuya sormaz)
+int is_bar_window(Window window)
+{
+    Client *c = client_find(window);
+    if (!c)
+        return 0;
+
+    if (c->window_type == _NET_WM_WINDOW_TYPE_DOCK)
+        return 1;
+
+    // Pencere ismini kontrol et (polybar veya lemonbar için)
+    return c->class_name &&
+           (strcmp(c->class_name, "Polybar") == 0 ||
+            strcmp(c->class_name, "lemonbar") == 0);
+}
+
+// Tüm dock istemcileri (strut kaydı)
+static Client *dock_list = NULL;
+
+// İstemciyi dock olarak kaydet
+void dock_register(Client *c)
+{
+    if (!c->is_dock)
+    {
+        c->is_dock = 1;
+        c->dock_next = dock_list;
+        dock_list = c;
+    }
+    c->dock_mapped = 1;
+    update_workarea();
+}
+
+// Dock kaydını sil (istemci silinmeden önce çağrılır)
+void dock_unregister(Client *c)
+{
+    for (Client **p = &dock_list; *p; p = &(*p)->dock_next)
+    {
+        if (*p == c)
+        {
+            *p = c->dock_next;
+            break;
+        }
+    }
+    c->is_dock = 0;
+    c->dock_mapped = 0;
+    update_workarea();
+}
+
+// [start, end] aralığı çıkışın [from, from + length) aralığıyla kesişiyor mu
+static int strut_overlaps(long start, long end, int from, int length)
+{
+    return start < from + length && end >= from;
+}
+
+// Çalışma alanlarını görünür dock'ların strut'larından yeniden hesapla.
+// Strut'lar kök pencere kenarlarına göredir; her çıkış yalnızca kendi
+// kenarına uzanan kısmı ayırır. Yalnızca dock'lar, strut'ları veya çıkışlar
+// değiştiğinde çağrılır; sonucu değişen çıkışların workspace'leri kirlenir
+// ve _NET_WORKAREA yeniden yayınlanır.
+void update_workarea()
+{
+    for (int m = 0; m < num_monitors; m++)
+    {
+        Monitor *mon = &monitors[m];
+        long left = 0, right = 0, top = 0, bottom = 0;
+
+        for (Client *c = dock_list; c; c = c->dock_next)
+        {
+            if (!c->dock_mapped)
+                continue;
+
+            if (c->has_strut)
+            {
+                long *st = c->strut;
+                if (st[0] && strut_overlaps(st[4], st[5], mon->y, mon->height) && st[0] - mon->x > left)
+                    left = st[0] - mon->x;
+                if (st[1] && strut_overlaps(st[6], st[7], mon->y, mon->height) &&
+                    mon->x + mon->width - (screen_width - st[1]) > right)
+                    right = mon->x + mon->width - (screen_width - st[1]);
+                if (st[2] && strut_overlaps(st[8], st[9], mon->x, mon->width) && st[2] - mon->y > top)
+                    top = st[2] - mon->y;
+                if (st[3] && strut_overlaps(st[10], st[11], mon->x, mon->width) &&
+                    mon->y + mon->height - (screen_height - st[3]) > bottom)
+                    bottom = mon->y + mon->height - (screen_height - st[3]);
+            }
+            else if (m != 0)
+            {
+                continue; // Strut'suz dock'lar ilk çıkışta varsayılır
+            }
+            else if (BAR_POSITION_TOP)
+            {
+                if (BAR_HEIGHT > top)
+                    top = BAR_HEIGHT;
+            }
+            else if (BAR_HEIGHT > bottom)
+            {
+                bottom = BAR_HEIGHT;
+            }
+        }
+
+        // Başka çıkışa ait strut'lar ayrılan alanı çıkış boyutunu aşırmasın
+        if (left + right >= mon->width)
+            left = right = 0;
+        if (top + bottom >= mon->height)
+            top = bottom = 0;
+
+        int x = mon->x + left;
+        int y = mon->y + top;
+        int width = mon->width - left - right;
+        int height = mon->height - top - bottom;
+
+        if (x == mon->wx && y == mon->wy &&
+            width == mon->wwidth && height == mon->wheight)
+        {
+            continue;
+        }
+
+        mon->wx = x;
+        mon->wy = y;
+        mon->wwidth = width;
+        mon->wheight = height;
+
+        // Görünen workspace bu olay grubunda, gizliler gösterilince düzenlenir
+        mark_monitor_layouts_dirty(m);
+        workarea_dirty = 1;
+        update_workspace_properties();
+    }
+}
+
+// Tiling moduna geç
 void toggle_tiling_mode()
 {
     // Aktif workspace'in modunu değiştir
     workspaces[current_workspace].mode =
         workspaces[current_workspace].mode == MODE_FLOATING ? MODE_TILING : MODE_FLOATING;
 
-    printf("Workspace %d modu değiştirildi: %s\n",
+    LOG(LOG_INFO, "Workspace %d modu değiştirildi: %s",
            current_workspace + 1,
            workspaces[current_workspace].mode == MODE_FLOATING ? "Serbest" : "Döşeli");
 
     // Mevcut workspace'teki pencereleri yeniden düzenle
-    rearrange_windows();
+    mark_layout_dirty(current_workspace);
+}
+
+// Çıkışları sola-üste göre sırala (Alt + , / . soldan sağa gezsin)
+static int monitor_before(const Monitor *a, const Monitor *b)
+{
+    return a->x != b->x ? a->x < b->x : a->y < b->y;
+}
+
+// Etkin çıkışların dikdörtgenlerini oku; RandR yoksa veya hiç etkin çıkış
+// bulunamazsa tüm ekran tek çıkış sayılır. Klonlanmış (aynı dikdörtgeni
+// gösteren) çıkışlar bir kez sayılır.
+static int query_outputs(Monitor *out, int max)
+{
+    int count = 0;
+
+#ifdef XRANDR
+    XRRScreenResources *res = XRRGetScreenResourcesCurrent(display, root);
+    for (int i = 0; res && i < res->ncrtc && count < max; i++)
+    {
+        XRRCrtcInfo *crtc = XRRGetCrtcInfo(display, res, res->crtcs[i]);
+        if (!crtc)
+            continue;
+
+        if (crtc->mode != None && crtc->noutput > 0 && crtc->width > 0 && crtc->height > 0)
+        {
+            int duplicate = 0;
+            for (int j = 0; j < count; j++)
+            {
+                if (out[j].x == crtc->x && out[j].y == crtc->y &&
+                    out[j].width == (int)crtc->width && out[j].height == (int)crtc->height)
+                    duplicate = 1;
+            }
+            if (!duplicate)
+            {
+                out[count].x = crtc->x;
+                out[count].y = crtc->y;
+                out[count].width = crtc->width;
+                out[count].height = crtc->height;
+                count++;
+            }
+        }
+        XRRFreeCrtcInfo(crtc);
+    }
+    if (res)
+        XRRFreeScreenResources(res);
+#endif
+
+    if (count == 0)
+    {
+        out[0].x = 0;
+        out[0].y = 0;
+        out[0].width = screen_width;
+        out[0].height = screen_height;
+        count = 1;
+    }
+
+    // Ekleme sıralaması; çıkış sayısı küçüktür
+    for (int i = 1; i < count; i++)
+    {
+        Monitor key = out[i];
+        int j = i - 1;
+        while (j >= 0 && monitor_before(&key, &out[j]))
+        {
+            out[j + 1] = out[j];
+            j--;
+        }
+        out[j + 1] = key;
+    }
+    return count;
+}
+
+// Gösterilmeyen ilk workspace'i bul (-1: hepsi görünür)
+static int first_hidden_workspace()
+{
+    for (int i = 0; i < num_workspaces; i++)
+    {
+        if (!workspace_visible(i))
+            return i;
+    }
+    return -1;
+}
+
+// Çıkış listesini yeniden oku ve mevcut durumla uzlaştır: var olan
+// çıkışlar workspace'lerini ve ana bölge oranlarını korur, yeni çıkışlara
+// gizli bir workspace verilir, kaybolan çıkışların workspace'leri gizlenir.
+void update_monitors()
+{
+    Monitor found[MAX_WORKSPACES];
+    int count = query_outputs(found, MAX_WORKSPACES);
+
+    // Her çıkışın ayrı bir workspace'i olmalı
+    if (count > num_workspaces)
+    {
+        resize_workspaces(count);
+        update_workspace_properties();
+    }
+
+    // Kaybolan çıkışlardaki pencereleri gizle
+    for (int m = count; m < num_monitors; m++)
+    {
+        for (Client *c = workspaces[monitors[m].workspace].head; c; c = c->next)
+        {
+            client_hide(c);
+        }
+    }
+
+    // Kaybolan bir çıkışa bağlı (görünen veya gizli) bütün workspace'ler
+    // ilk çıkışa geçer; gösterildiklerinde oranın yeni alanına göre dizilsinler
+    for (int i = 0; i < num_workspaces; i++)
+    {
+        if (workspaces[i].monitor >= count)
+        {
+            workspaces[i].monitor = 0;
+            mark_layout_dirty(i);
+        }
+    }
+
+    Monitor *resized = realloc(monitors, count * sizeof(Monitor));
+    if (!resized)
+    {
+        perror("realloc");
+        exit(EXIT_FAILURE);
+    }
+    monitors = resized;
+
+    int old_count = num_monitors;
+    num_monitors = count;
+    for (int m = 0; m < count; m++)
+    {
+        if (m >= old_count)
+        {
+            monitors[m].workspace = -1; // first_hidden_workspace() için henüz yok
+            monitors[m].master_percent = MASTER_SIZE * 100.0;
+        }
+        else if (monitors[m].x == found[m].x && monitors[m].y == found[m].y &&
+                 monitors[m].width == found[m].width && monitors[m].height == found[m].height)
+        {
+            continue;
+        }
+
+        monitors[m].x = found[m].x;
+        monitors[m].y = found[m].y;
+        monitors[m].width = found[m].width;
+        monitors[m].height = found[m].height;
+        monitors[m].wx = monitors[m].wy = monitors[m].wwidth = monitors[m].wheight = 0; // Yeniden hesaplat
+    }
+
+    // Yeni çıkışlara gizli bir workspace ata ve göster
+    for (int m = old_count; m < count; m++)
+    {
+        monitor_show_workspace(m, first_hidden_workspace());
+    }
+
+    if (current_monitor >= num_monitors)
+        current_monitor = 0;
+    current_workspace = monitors[current_monitor].workspace;
+
+    // Odaktaki pencere gizlenen bir workspace'te kaldıysa odağı taşı
+    Client *focused = client_find(focused_window);
+    if (focused && focused->workspace >= 0 && !workspace_visible(focused->workspace))
+        focus_last_in_workspace(current_workspace);
+
+    if (count != old_count)
+    {
+        LOG(LOG_INFO, "Çıkış sayısı: %d", num_monitors);
+        update_workspace_properties();
+    }
+    for (int m = 0; m < count; m++)
+    {
+        LOG(LOG_DEBUG, "Çıkış %d: %dx%d+%d+%d, workspace %d", m, monitors[m].width,
+            monitors[m].height, monitors[m].x, monitors[m].y, monitors[m].workspace + 1);
+    }
 }
 
 // Ekran boyutlarını güncelle
@@ -434,121 +1634,510 @@ void update_screen_dimensions()
     Screen *screen = DefaultScreenOfDisplay(display);
     screen_width = WidthOfScreen(screen);
     screen_height = HeightOfScreen(screen);
-    // Ana bölge genişliğini yüzdeye göre güncelle
-    master_width = (int)((float)screen_width * (master_size_percent / 100.0));
+
+    // Çıkışları ve çalışma alanlarını yeni ekran boyutlarına göre hesapla
+    update_monitors();
+    update_workarea();
 }
 
-// Aktif workspace'teki pencereleri düzenle
-void rearrange_windows()
+// Kök ConfigureNotify veya RRScreenChangeNotify: yalnızca boyutu kaydet ve
+// işaretle. Takma/çıkarma sırasında gelen olay seli, kuyruk boşalınca
+// flush_screen_change() içinde tek bir hesapla karşılanır.
+void handle_screen_change(XEvent *event)
 {
-    Workspace *ws = &workspaces[current_workspace];
+    stats.screen_events++;
 
-    // Eğer bu workspace serbest modda ise düzenleme yapma
-    if (ws->mode == MODE_FLOATING)
+#ifdef XRANDR
+    XRRUpdateConfiguration(event); // Xlib'in ekran boyutlarını güncelle
+    if (event->type == randr_event_base + RRScreenChangeNotify)
     {
+        XRRScreenChangeNotifyEvent *change = (XRRScreenChangeNotifyEvent *)event;
+        screen_width = change->width;
+        screen_height = change->height;
+    }
+#endif
+    if (event->type == ConfigureNotify)
+    {
+        screen_width = event->xconfigure.width;
+        screen_height = event->xconfigure.height;
+    }
+    screen_change_pending = 1;
+}
+
+// Hiçbir çıkışla kesişmeyen serbest pencereleri workspace'lerinin çıkışına
+// getir (çıkarılan ekranda kalan pencereler). Gizli workspace'ler de dahil:
+// çıkışı kaybolan gizli workspace gösterildiğinde pencereleri ekranda olsun.
+// Yalnızca ekran değişiminde çağrılır; bilinen son geometriyle çalışır,
+// sunucuya soru sorulmaz.
+static void rescue_floating_windows()
+{
+    for (int i = 0; i < num_workspaces; i++)
+    {
+        Workspace *ws = &workspaces[i];
+        for (Client *c = ws->head; c; c = c->next)
+        {
+            if (ws->mode == MODE_TILING && !c->is_dialog)
+                continue;
+
+            int visible = 0;
+            for (int o = 0; o < num_monitors && !visible; o++)
+            {
+                Monitor *out = &monitors[o];
+                visible = c->x < out->x + out->width && c->x + c->width > out->x &&
+                          c->y < out->y + out->height && c->y + c->height > out->y;
+            }
+            if (!visible)
+            {
+                Monitor *mon = &monitors[ws->monitor];
+                c->x = mon->wx + (mon->wwidth - c->width) / 2;
+                c->y = mon->wy + (mon->wheight - c->height) / 2;
+                // Park edilmiş pencere gösterilirken bu konuma taşınır
+                if (!(c->hidden && hide_strategy == HIDE_PARK))
+                    XMoveWindow(display, c->window, c->x, c->y);
+                client_forget_geometry(c->window);
+            }
+        }
+    }
+}
+
+// Bekleyen ekran değişikliğini bir kez işle: çıkışları ve çalışma alanlarını
+// yeniden hesapla. Görünen döşeli workspace'ler aynı olay grubunda
+// flush_layouts() ile düzenlenir, gizliler gösterildiklerinde.
+void flush_screen_change()
+{
+    if (!screen_change_pending)
         return;
+    screen_change_pending = 0;
+    stats.screen_changes++;
+
+    update_monitors();
+    update_workarea();
+    rescue_floating_windows();
+    LOG(LOG_INFO, "Ekran değişti: %dx%d, %d çıkış", screen_width, screen_height, num_monitors);
+}
+
+// Verilen kök koordinatındaki çıkış (hiçbiri değilse odaktaki)
+int monitor_at(int x, int y)
+{
+    for (int m = 0; m < num_monitors; m++)
+    {
+        if (x >= monitors[m].x && x < monitors[m].x + monitors[m].width &&
+            y >= monitors[m].y && y < monitors[m].y + monitors[m].height)
+            return m;
     }
+    return current_monitor;
+}
+
+// Odaktaki çıkışı değiştir; aktif workspace o çıkışta görünen olur
+void select_monitor(int monitor)
+{
+    if (monitor < 0 || monitor >= num_monitors || monitor == current_monitor)
+        return;
 
-    int window_count = ws->window_count;
-    if (window_count == 0)
+    current_monitor = monitor;
+    current_workspace = monitors[monitor].workspace;
+    update_workspace_properties();
+    LOG(LOG_DEBUG, "Çıkış %d seçildi (workspace %d)", monitor, current_workspace + 1);
+}
+
+// Alt + , / .: Komşu çıkışa geç ve oradaki son pencereye odaklan
+void focus_monitor(int delta)
+{
+    if (num_monitors < 2)
+        return;
+
+    select_monitor((current_monitor + delta + num_monitors) % num_monitors);
+    focus_last_in_workspace(current_workspace);
+}
+
+// Workspace'i yeniden düzenlenecek olarak işaretle; asıl düzenleme olay
+// kuyruğu boşaldıktan sonra flush_layouts() içinde bir kez yapılır. Gizli
+// workspace'ler yalnızca bayatlar, gösterildiklerinde bir kez düzenlenir.
+void mark_layout_dirty(int workspace)
+{
+    if (workspace < 0 || workspace >= num_workspaces)
+        return;
+
+    if (workspaces[workspace].layout_dirty)
     {
+        stats.relayouts_skipped++;
         return;
     }
+    workspaces[workspace].layout_dirty = 1;
+    if (!workspace_visible(workspace))
+        stats.relayouts_deferred++;
+}
 
-    update_screen_dimensions_with_bar();
+// Bir çıkışa bağlı bütün workspace'lerin yerleşimini bayatlat (çalışma
+// alanı veya ana bölge oranı değişti)
+void mark_monitor_layouts_dirty(int monitor)
+{
+    for (int i = 0; i < num_workspaces; i++)
+    {
+        if (workspaces[i].monitor == monitor && workspaces[i].mode == MODE_TILING)
+            mark_layout_dirty(i);
+    }
+}
 
-    // Boşlukları hesapla
-    int effective_outer_gap = gaps_enabled ? outer_gap : 0;
-    int effective_inner_gap = gaps_enabled ? inner_gap : 0;
+// Görünen kirli workspace'leri düzenle; gizliler bayat kalır
+void flush_layouts()
+{
+    for (int i = 0; i < num_workspaces; i++)
+    {
+        if (!workspaces[i].layout_dirty)
+            continue;
+
+        if (!workspace_visible(i))
+            continue;
+        workspaces[i].layout_dirty = 0;
+        rearrange_windows(i);
+    }
+}
+
+// Pencereyi gizle: ya eşlemesini kaldır ya da ekran dışına park et
+void client_hide(Client *c)
+{
+    if (c->hidden)
+        return;
+    c->hidden = 1;
+
+    if (hide_strategy == HIDE_PARK)
+        XMoveWindow(display, c->window, PARK_X, c->y);
+    else
+        XUnmapWindow(display, c->window);
+}
+
+// Gizli pencereyi bilinen konumunda göster
+void client_show(Client *c)
+{
+    if (!c->hidden)
+        return;
+    c->hidden = 0;
 
-    // Çalışma alanını hesapla
-    int work_x = effective_outer_gap;
-    int work_y = effective_screen_y + effective_outer_gap; // Bar'ı hesaba kat
-    int work_width = screen_width - (2 * effective_outer_gap);
-    int work_height = effective_screen_height - (2 * effective_outer_gap); // Bar'ı hesaba kat
+    if (hide_strategy == HIDE_PARK)
+        XMoveWindow(display, c->window, c->x, c->y);
+    else
+        XMapWindow(display, c->window);
+    switch_reveal_window = c->window;
+}
 
-    // Dialog olmayan pencere sayısını hesapla
-    int non_dialog_count = 0;
-    for (int i = 0; i < window_count; i++)
+// İstemci pencereleri için ConfigureNotify: bilinen konumu güncelle
+// (park konumu kaydedilmez, pencere oraya geri getirilmemeli)
+void handle_configure_notify(XConfigureEvent *event)
+{
+    Client *c = client_find(event->window);
+    if (c && event->x != PARK_X)
     {
-        if (!is_dialog_window(ws->windows[i]))
-        {
-            non_dialog_count++;
-        }
+        c->x = event->x;
+        c->y = event->y;
+        c->width = event->width;
+        c->height = event->height;
     }
+    // Park edilmişken gelen (yerleşimin boyut) isteği gösterme değildir
+    if (event->window == switch_reveal_window && hide_strategy == HIDE_PARK &&
+        event->x != PARK_X)
+        finish_switch_measurement();
+}
+
+// Değişim gecikmesi: sunucu son gösterilen pencere için MapNotify
+// (unmap) veya ConfigureNotify (park) ürettiğinde ölçüm biter
+void finish_switch_measurement()
+{
+    if (!switch_start_us)
+        return;
+
+    unsigned long elapsed = now_us() - switch_start_us;
+    switch_start_us = 0;
+    switch_reveal_window = None;
 
-    if (non_dialog_count == 0)
+    stats.switches++;
+    stats.switch_us_last = elapsed;
+    stats.switch_us_total += elapsed;
+    if (elapsed > stats.switch_us_max)
+        stats.switch_us_max = elapsed;
+    LOG(LOG_DEBUG, "Workspace değişimi %lu µs sürdü", elapsed);
+}
+
+void sync_check_timeouts();
+
+// İstemciden bir sonraki yapılandırmayı çizdiğinde sayacı artırmasını iste
+static void client_send_sync_request(Client *c)
+{
+    XSyncValue one;
+    int overflow;
+    XSyncIntToValue(&one, 1);
+    XSyncValueAdd(&c->sync_value, c->sync_value, one, &overflow);
+
+    XEvent ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.type = ClientMessage;
+    ev.xclient.window = c->window;
+    ev.xclient.message_type = WM_PROTOCOLS;
+    ev.xclient.format = 32;
+    ev.xclient.data.l[0] = _NET_WM_SYNC_REQUEST;
+    ev.xclient.data.l[1] = CurrentTime;
+    ev.xclient.data.l[2] = XSyncValueLow32(c->sync_value);
+    ev.xclient.data.l[3] = XSyncValueHigh32(c->sync_value);
+    XSendEvent(display, c->window, False, NoEventMask, &ev);
+
+    // Alarmı yeni değere kur (değiştirmek tetiklenmiş alarmı yeniden etkinleştirir)
+    XSyncAlarmAttributes attrs;
+    attrs.trigger.wait_value = c->sync_value;
+    XSyncChangeAlarm(display, c->sync_alarm, XSyncCAValue, &attrs);
+
+    client_set_sync_waiting(c, 1);
+    c->sync_sent = now_ms();
+    if (timers[TIMER_SYNC].deadline == 0)
+        timer_schedule(TIMER_SYNC, SYNC_TIMEOUT, sync_check_timeouts);
+    stats.sync_requests++;
+}
+
+// Geometriyi sunucuya gönder. İstemci önceki boyutlandırmayı henüz çizmediyse
+// istek bekletilir ve sonrakilerle birleştirilir; onay gelince sonuncusu gider.
+// Park edilmiş pencereye yalnızca boyut uygulanır; konum gösterilirken.
+void client_configure(Client *c, int x, int y, int width, int height)
+{
+    if (c->sync_waiting)
     {
-        return; // Sadece dialog pencereleri varsa düzenleme yapma
+        c->held_x = x;
+        c->held_y = y;
+        c->held_width = width;
+        c->held_height = height;
+        c->sync_held = 1;
+        stats.sync_held++;
+        return;
     }
 
-    if (non_dialog_count == 1)
+    if (c->sync_counter != None && (width != c->width || height != c->height))
+        client_send_sync_request(c);
+
+    XMoveResizeWindow(display, c->window,
+                      c->hidden && hide_strategy == HIDE_PARK ? PARK_X : x,
+                      y, width, height);
+    c->x = x;
+    c->y = y;
+    c->width = width;
+    c->height = height;
+}
+
+// Onay geldi (veya beklemekten vazgeçildi): bekletilen geometriyi gönder
+static void client_sync_done(Client *c)
+{
+    client_set_sync_waiting(c, 0);
+    if (c->sync_held)
+    {
+        c->sync_held = 0;
+        client_configure(c, c->held_x, c->held_y, c->held_width, c->held_height);
+    }
+}
+
+// Sayacı yok edilen alarmın istemcisi: beklemese de senkronizasyon kapanır,
+// yoksa sonraki XSyncChangeAlarm ölü alarma gider. Nadir olduğundan tablo
+// taranır.
+static void handle_sync_alarm_destroyed(XSyncAlarm alarm)
+{
+    for (unsigned long i = 0; i < client_table_size; i++)
+    {
+        Client *c = client_table[i];
+        if (!c || c->sync_alarm != alarm)
+            continue;
+
+        c->sync_alarm = None;
+        c->sync_counter = None;
+        client_sync_done(c);
+        return;
+    }
+}
+
+// Sayaç istenen değere ulaştı. Alarm yalnızca istek gönderilince kurulur;
+// beklemeyen istemcinin bu olayı (örn. eski bir tetiklenme) yok sayılır.
+void handle_sync_alarm(XSyncAlarmNotifyEvent *event)
+{
+    if (event->state == XSyncAlarmDestroyed)
+    {
+        handle_sync_alarm_destroyed(event->alarm);
+        return;
+    }
+
+    for (Client *c = sync_waiting_head; c; c = c->sync_next)
+    {
+        if (c->sync_alarm != event->alarm)
+            continue;
+
+        if (XSyncValueGreaterOrEqual(event->counter_value, c->sync_value))
+            client_sync_done(c);
+        return;
+    }
+}
+
+// Onay vermeyen (donmuş veya protokolü yanlış uygulayan) istemciler için
+// beklemeyi bırak; istemci eski davranışla yapılandırılmaya devam eder
+void sync_check_timeouts()
+{
+    unsigned long now = now_ms();
+    unsigned long next = 0;
+
+    // Yeniden istek gönderen istemci listenin başına eklenir, tekrar görülmez
+    Client *next_client;
+    for (Client *c = sync_waiting_head; c; c = next_client)
     {
-        // Tek normal pencere varsa, çalışma alanını kapla
-        for (int i = 0; i < window_count; i++)
+        next_client = c->sync_next;
+        if (now - c->sync_sent >= SYNC_TIMEOUT)
         {
-            if (!is_dialog_window(ws->windows[i]))
-            {
-                XMoveResizeWindow(display, ws->windows[i],
-                                  work_x,
-                                  work_y,
-                                  work_width,
-                                  work_height);
-                break;
-            }
+            LOG(LOG_DEBUG, "Pencere %ld boyutlandırmayı onaylamadı", c->window);
+            stats.sync_timeouts++;
+            client_sync_done(c);
+        }
+        if (c->sync_waiting)
+        {
+            unsigned long remaining = SYNC_TIMEOUT - (now - c->sync_sent);
+            if (next == 0 || remaining < next)
+                next = remaining;
         }
+    }
+
+    if (next != 0)
+        timer_schedule(TIMER_SYNC, next, sync_check_timeouts);
+}
+
+// Pencereyi verilen dikdörtgene taşı; son uygulanan geometriyle aynıysa
+// istek gönderme (gereksiz ConfigureNotify ve yeniden çizimi önler)
+void client_move_resize(Client *c, int x, int y, int width, int height)
+{
+    if (c->geom_known && c->geom_x == x && c->geom_y == y &&
+        c->geom_width == width && c->geom_height == height)
+    {
+        stats.configures_elided++;
         return;
     }
 
-    // Ana bölge genişliğini yüzdeye göre hesapla
-    int master_area_width = (int)((float)work_width * (master_size_percent / 100.0));
+    client_configure(c, x, y, width, height);
+    c->geom_x = x;
+    c->geom_y = y;
+    c->geom_width = width;
+    c->geom_height = height;
+    c->geom_known = 1;
+    stats.configures_sent++;
+}
+
+// Pencere yerleşim dışında taşındı; bir sonraki yerleşimde isteği zorla
+void client_forget_geometry(Window w)
+{
+    Client *c = client_find(w);
+    if (c)
+        c->geom_known = 0;
+}
+
+// Yerleşim için büyüyebilen geçici diziler
+static Client **layout_clients = NULL;
+static Rect *layout_rects = NULL;
+static int layout_capacity = 0;
 
-    // Ana pencereyi yerleştir
-    int master_placed = 0;
-    for (int i = 0; i < window_count; i++)
+// Workspace'teki pencereleri düzenle: önce yerleşimi hesapla, sonra uygula
+void rearrange_windows(int workspace)
+{
+    Workspace *ws = &workspaces[workspace];
+
+    // Eğer bu workspace serbest modda ise düzenleme yapma
+    if (ws->mode == MODE_FLOATING)
     {
-        if (!is_dialog_window(ws->windows[i]))
+        return;
+    }
+
+    if (ws->window_count == 0)
+    {
+        return;
+    }
+
+    stats.relayouts++;
+
+    if (ws->window_count > layout_capacity)
+    {
+        int capacity = layout_capacity ? layout_capacity : 64;
+        while (capacity < ws->window_count)
+            capacity *= 2;
+        layout_clients = realloc(layout_clients, capacity * sizeof(Client *));
+        layout_rects = realloc(layout_rects, capacity * sizeof(Rect));
+        if (!layout_clients || !layout_rects)
         {
-            if (!master_placed)
-            {
-                XMoveResizeWindow(display, ws->windows[i],
-                                  work_x,
-                                  work_y,
-                                  master_area_width - effective_inner_gap,
-                                  work_height);
-                master_placed = 1;
-                break;
-            }
+            perror("realloc");
+            exit(EXIT_FAILURE);
         }
+        layout_capacity = capacity;
     }
 
-    // Yığın bölgesini hesapla
-    int stack_x = work_x + master_area_width + effective_inner_gap;
-    int stack_width = work_width - master_area_width - effective_inner_gap;
-    int stack_height = (work_height - ((non_dialog_count - 2) * effective_inner_gap)) / (non_dialog_count - 1);
-
-    // Diğer pencereleri yığında düzenle
-    int stack_y = work_y;
-    int stack_count = 0;
-    for (int i = 0; i < window_count; i++)
+    // Dialog olmayan pencereleri topla
+    int count = 0;
+    for (Client *c = ws->head; c; c = c->next)
     {
-        if (!is_dialog_window(ws->windows[i]))
+        if (!c->is_dialog)
         {
-            if (stack_count > 0)
-            { // İlk pencere ana bölgede
-                XMoveResizeWindow(display, ws->windows[i],
-                                  stack_x,
-                                  stack_y,
-                                  stack_width,
-                                  stack_height);
-                stack_y += stack_height + effective_inner_gap;
-            }
-            stack_count++;
+            layout_clients[count++] = c;
         }
     }
 
-    // Değişiklikleri hemen uygula
-    XSync(display, False);
+    if (count == 0)
+    {
+        return; // Sadece dialog pencereleri varsa düzenleme yapma
+    }
+
+    // Boşlukları hesapla
+    int effective_outer_gap = gaps_enabled ? outer_gap : 0;
+    int effective_inner_gap = gaps_enabled ? inner_gap : 0;
+
+    // Workspace'in çıkışındaki çalışma alanını hesapla (dock'lar hariç)
+    Monitor *mon = &monitors[ws->monitor];
+    Rect area;
+    area.x = mon->wx + effective_outer_gap;
+    area.y = mon->wy + effective_outer_gap;
+    area.width = mon->wwidth - (2 * effective_outer_gap);
+    area.height = mon->wheight - (2 * effective_outer_gap);
+
+    LayoutParams params;
+    params.master_percent = mon->master_percent;
+    params.nmaster = ws->nmaster;
+    params.gap = effective_inner_gap;
+
+    layouts[ws->layout].arrange(area, count, &params, layout_rects);
+
+    // Hesaplanan dikdörtgenleri uygula
+    for (int i = 0; i < count; i++)
+    {
+        Rect *r = &layout_rects[i];
+        client_move_resize(layout_clients[i],
+                           r->x, r->y,
+                           r->width > 0 ? r->width : 1,
+                           r->height > 0 ? r->height : 1);
+    }
+}
+
+// Aktif workspace'in yerleşimini sıradakiyle değiştir
+void cycle_layout()
+{
+    Workspace *ws = &workspaces[current_workspace];
+    ws->layout = (ws->layout + 1) % layout_count;
+    LOG(LOG_INFO, "Workspace %d yerleşimi: %s", current_workspace + 1, layouts[ws->layout].name);
+    mark_layout_dirty(current_workspace);
+}
+
+// Ana bölgedeki pencere sayısını değiştir
+void adjust_nmaster(int delta)
+{
+    Workspace *ws = &workspaces[current_workspace];
+    ws->nmaster += delta;
+    if (ws->nmaster < 0)
+        ws->nmaster = 0;
+    LOG(LOG_INFO, "Ana bölge pencere sayısı: %d", ws->nmaster);
+    mark_layout_dirty(current_workspace);
+}
+
+// Bu workspace'te sürüklemenin çerçeveyle yapılmasını aç/kapat
+void toggle_outline_drag()
+{
+    Workspace *ws = &workspaces[current_workspace];
+    ws->outline_drag = !ws->outline_drag;
+    LOG(LOG_INFO, "Workspace %d çerçeveyle sürükleme: %s",
+        current_workspace + 1, ws->outline_drag ? "açık" : "kapalı");
 }
 
 // Ana bölge genişliğini yüzdesel olarak ayarla
@@ -557,30 +2146,28 @@ void adjust_master_size(float delta_percent)
     // Eğer mevcut workspace tiling modunda değilse işlem yapma
     if (workspaces[current_workspace].mode != MODE_TILING)
     {
-        printf("Master boyutu sadece tiling modunda ayarlanabilir\n");
+        LOG(LOG_INFO, "Master boyutu sadece tiling modunda ayarlanabilir");
         return;
     }
 
-    // Yeni yüzdeyi hesapla
-    master_size_percent += delta_percent;
+    // Yeni yüzdeyi hesapla (oran çıkışa aittir)
+    Monitor *mon = &monitors[current_monitor];
+    mon->master_percent += delta_percent;
 
     // Sınırları kontrol et (%10 ile %90 arası)
-    if (master_size_percent < 10.0)
+    if (mon->master_percent < 10.0)
     {
-        master_size_percent = 10.0;
+        mon->master_percent = 10.0;
     }
-    else if (master_size_percent > 90.0)
+    else if (mon->master_percent > 90.0)
     {
-        master_size_percent = 90.0;
+        mon->master_percent = 90.0;
     }
 
-    // Piksel cinsinden genişliği hesapla
-    master_width = (int)((float)screen_width * (master_size_percent / 100.0));
+    LOG(LOG_INFO, "Ana bölge genişliği: %.1f%%", mon->master_percent);
 
-    printf("Ana bölge genişliği: %.1f%%\n", master_size_percent);
-
-    // Pencereleri yeni boyutlara göre düzenle
-    rearrange_windows();
+    // Bu çıkıştaki pencereleri yeni boyutlara göre düzenle
+    mark_monitor_layouts_dirty(current_monitor);
 }
 
 // Ana pencere ile bir sonraki pencereyi değiştir
@@ -594,130 +2181,203 @@ void swap_master()
     }
 
     // İlk iki pencereyi değiştir
-    Window temp = ws->windows[0];
-    ws->windows[0] = ws->windows[1];
-    ws->windows[1] = temp;
+    Client *second = ws->head->next;
+    workspace_unlink(ws, second);
+    workspace_insert_before(ws, second, ws->head);
 
     // Pencereleri yeniden düzenle
-    rearrange_windows();
+    mark_layout_dirty(current_workspace);
+
+    LOG(LOG_INFO, "Ana pencere değiştirildi");
+}
 
-    printf("Ana pencere değiştirildi\n");
+// Workspace dizisini yeniden boyutlandır; yeni workspace'ler boş ve serbest
+// modda başlar. Küçültmeden önce pencereler taşınmış olmalıdır.
+void resize_workspaces(int count)
+{
+    Workspace *resized = realloc(workspaces, count * sizeof(Workspace));
+    if (!resized)
+    {
+        perror("realloc");
+        exit(EXIT_FAILURE);
+    }
+    workspaces = resized;
+
+    for (int i = num_workspaces; i < count; i++)
+    {
+        memset(&workspaces[i], 0, sizeof(Workspace));
+        workspaces[i].mode = MODE_FLOATING; // Başlangıçta serbest mod
+        workspaces[i].layout = 0;
+        workspaces[i].nmaster = NMASTER;
+        workspaces[i].outline_drag = outline_drag_default;
+    }
+    num_workspaces = count;
 }
 
 // Workspace yönetimi fonksiyonları
 void init_workspaces()
 {
-    for (int i = 0; i < NUM_WORKSPACES; i++)
+    int count = NUM_WORKSPACES;
+    const char *count_env = getenv("MWM_WORKSPACES");
+    if (count_env && atoi(count_env) > 0)
     {
-        workspaces[i].window_count = 0;
-        workspaces[i].mode = MODE_FLOATING; // Başlangıçta serbest mod
-        for (int j = 0; j < MAX_WINDOWS; j++)
-        {
-            workspaces[i].windows[j] = None;
-        }
+        count = atoi(count_env);
+    }
+    if (count > MAX_WORKSPACES)
+    {
+        count = MAX_WORKSPACES;
     }
-    printf("Workspaces başlatıldı\n");
+
+    resize_workspaces(count);
+    LOG(LOG_INFO, "Workspaces başlatıldı (%d)", num_workspaces);
 }
 
-// Pencereyi workspace'e ekle
+// Pencereyi workspace'e ekle (başka bir workspace'teyse oradan taşınır)
 void add_window_to_workspace(Window w, int workspace)
 {
-    if (workspace < 0 || workspace >= NUM_WORKSPACES)
-        return;
-    if (workspaces[workspace].window_count >= MAX_WINDOWS)
+    if (workspace < 0 || workspace >= num_workspaces)
         return;
 
     // Pencere zaten bu workspace'te mi kontrol et
-    for (int i = 0; i < workspaces[workspace].window_count; i++)
+    Client *c = client_find(w);
+    if (c && c->workspace >= 0)
     {
-        if (workspaces[workspace].windows[i] == w)
+        if (c->workspace == workspace)
             return;
+        remove_window_from_workspace(w, c->workspace);
     }
 
-    workspaces[workspace].windows[workspaces[workspace].window_count++] = w;
-    printf("Pencere %ld workspace %d'e eklendi\n", w, workspace + 1);
+    c = client_add(w);
+    c->workspace = workspace;
+    workspace_insert_before(&workspaces[workspace], c, NULL);
+    focus_history_append(&workspaces[workspace], c);
+
+    // EWMH: yeni pencere listeye eklenir, _NET_WM_DESKTOP yalnızca değiştiyse yazılır
+    if (!c->listed)
+        client_list_append(c);
+    if (c->published_desktop != workspace)
+        desktop_updates_pending = 1;
+    update_workspace_properties();
+    LOG(LOG_DEBUG, "Pencere %ld workspace %d'e eklendi", w, workspace + 1);
 }
 
-// Pencereyi workspace'den kaldır
+// Pencereyi workspace'den kaldır (istemci kaydı korunur)
 void remove_window_from_workspace(Window w, int workspace)
 {
-    if (workspace < 0 || workspace >= NUM_WORKSPACES)
+    Client *c = client_find(w);
+    if (!c || c->workspace < 0 || c->workspace != workspace)
         return;
 
-    for (int i = 0; i < workspaces[workspace].window_count; i++)
-    {
-        if (workspaces[workspace].windows[i] == w)
-        {
-            // Pencereyi listeden çıkar ve diğerlerini kaydır
-            for (int j = i; j < workspaces[workspace].window_count - 1; j++)
-            {
-                workspaces[workspace].windows[j] = workspaces[workspace].windows[j + 1];
-            }
-            workspaces[workspace].window_count--;
-            printf("Pencere %ld workspace %d'den kaldırıldı\n", w, workspace + 1);
-            break;
-        }
-    }
+    workspace_unlink(&workspaces[workspace], c);
+    focus_history_unlink(&workspaces[workspace], c);
+    c->workspace = -1;
+    LOG(LOG_DEBUG, "Pencere %ld workspace %d'den kaldırıldı", w, workspace + 1);
 }
 
-// Workspace'i değiştir
-void switch_workspace(int new_workspace)
+// Pencereyi yönetimden çıkar: workspace'ten ve istemci kaydından sil
+void unmanage_window(Window w)
 {
-    if (new_workspace < 0 || new_workspace >= NUM_WORKSPACES)
-        return;
-    if (new_workspace == current_workspace)
+    Client *c = client_find(w);
+    if (!c)
         return;
 
-    printf("Workspace değiştiriliyor: %d -> %d\n", current_workspace + 1, new_workspace + 1);
+    remove_window_from_workspace(w, c->workspace);
+    if (c->listed)
+        client_list_remove(c);
+    client_remove(w);
+}
+
+// Çıkışta başka bir workspace göster. Yeni workspace gizliyken
+// yerleştirilir, sonra pencereleri tek seferde gösterilir ve eskiler
+// gizlenir; böylece pencereler eski geometride görünüp zıplamaz.
+// Yeni workspace gizli olmalıdır.
+void monitor_show_workspace(int monitor, int workspace)
+{
+    Monitor *mon = &monitors[monitor];
+    int old_workspace = mon->workspace;
 
-    is_switching_workspace = 1; // Workspace değişimi başladı
+    switch_start_us = now_us();
+    switch_reveal_window = None;
 
-    // Mevcut workspace'deki pencereleri gizle
-    for (int i = 0; i < workspaces[current_workspace].window_count; i++)
+    mon->workspace = workspace;
+    if (workspaces[workspace].monitor != monitor)
     {
-        Window w = workspaces[current_workspace].windows[i];
-        if (w != None)
-        {
-            XUnmapWindow(display, w);
-        }
+        // Başka çıkıştan gelen workspace yeni çalışma alanına yerleşmeli
+        workspaces[workspace].monitor = monitor;
+        workarea_dirty = 1;
+        mark_layout_dirty(workspace);
+    }
+    if (monitor == current_monitor)
+        current_workspace = workspace;
+
+    // Önce yerleşim: bayat workspace pencereler hâlâ gizliyken bir kez
+    // düzenlenir. Çalışma alanı henüz hesaplanmamışsa (yeni çıkış)
+    // flush_layouts() yerleştirir.
+    if (workspaces[workspace].layout_dirty && mon->wwidth > 0)
+    {
+        workspaces[workspace].layout_dirty = 0;
+        rearrange_windows(workspace);
     }
 
-    // Yeni workspace'e geç
-    current_workspace = new_workspace;
+    if (switch_grab_server)
+        XGrabServer(display);
 
-    // Yeni workspace'deki pencereleri göster
-    for (int i = 0; i < workspaces[current_workspace].window_count; i++)
+    // Yeni pencereleri göster, ardından eskileri gizle (arada boş masaüstü
+    // görünmez)
+    for (Client *c = workspaces[workspace].head; c; c = c->next)
     {
-        Window w = workspaces[current_workspace].windows[i];
-        if (w != None)
+        client_show(c);
+    }
+    if (old_workspace >= 0)
+    {
+        for (Client *c = workspaces[old_workspace].head; c; c = c->next)
         {
-            XMapWindow(display, w);
+            client_hide(c);
         }
     }
 
-    // Workspace değişiklik bildirimini göster
-    show_workspace_notification(current_workspace);
+    if (switch_grab_server)
+        XUngrabServer(display);
 
-    // Yeni workspace'in moduna göre pencereleri düzenle
-    if (workspaces[current_workspace].mode == MODE_TILING)
+    // Gösterilecek pencere yoksa sunucudan olay beklenmez
+    if (switch_reveal_window == None)
+        finish_switch_measurement();
+}
+
+// Workspace'i değiştir. İstenen workspace başka bir çıkışta zaten
+// görünüyorsa o çıkışa geçilir; pencereler yer değiştirmez.
+void switch_workspace(int new_workspace)
+{
+    if (new_workspace < 0 || new_workspace >= num_workspaces)
+        return;
+    if (new_workspace == current_workspace)
+        return;
+
+    LOG(LOG_DEBUG, "Workspace değiştiriliyor: %d -> %d", current_workspace + 1, new_workspace + 1);
+
+    if (workspace_visible(new_workspace))
     {
-        rearrange_windows();
+        select_monitor(workspaces[new_workspace].monitor);
     }
-
-    // Eğer yeni workspace'te pencere varsa, son pencereye odaklan
-    if (workspaces[current_workspace].window_count > 0)
+    else
     {
-        Window last_window = workspaces[current_workspace].windows[workspaces[current_workspace].window_count - 1];
-        focus_window(last_window);
+        is_switching_workspace = 1; // Workspace değişimi başladı
+        monitor_show_workspace(current_monitor, new_workspace);
     }
 
-    XSync(display, False);
+    // Workspace değişiklik bildirimini göster
+    show_workspace_notification(current_workspace);
+
+    // Workspace'te en son odaklanan pencereye dön
+    focus_last_in_workspace(current_workspace);
 
     // EWMH özelliklerini güncelle
     update_workspace_properties();
 }
 
-// Pencereyi odakla
+// Pencereyi odakla. Odak değişmiyorsa hiçbir istek gönderilmez; değişirse
+// yalnızca iki kenarlık rengi ve giriş odağı gönderilir, _NET_ACTIVE_WINDOW
+// olay grubu sonunda yazılır. Kenarlık kalınlığı yönetime alınırken ayarlanır.
 void focus_window(Window window)
 {
     if (window == None || window == root)
@@ -725,35 +2385,140 @@ void focus_window(Window window)
         return;
     }
 
+    // Gecikmeli odak bekliyorsa artık geçersizdir
+    if (pending_focus != None)
+    {
+        timer_cancel(TIMER_FOCUS);
+        pending_focus = None;
+    }
+
+    if (window == focused_window)
+    {
+        stats.focus_noops++;
+        return;
+    }
+
     // Önceki odaklanmış pencereyi temizle
     if (focused_window != None)
     {
         XSetWindowBorder(display, focused_window, WINDOW_BORDER_FG); // Siyah kenarlık
-        XSetWindowBorderWidth(display, focused_window, BORDER_WIDTH);
     }
 
     // Yeni pencereyi odakla
     focused_window = window;
     XSetWindowBorder(display, window, ACTIVE_WINDOW_BORDER_FG); // Mavi tonunda kenarlık
-    XSetWindowBorderWidth(display, window, BORDER_WIDTH);
     XSetInputFocus(display, window, RevertToPointerRoot, CurrentTime);
-    XRaiseWindow(display, window);
+    stats.focus_changes++;
+
+    Client *c = client_find(window);
+    if (c && workspace_visible(c->workspace))
+        select_monitor(workspaces[c->workspace].monitor);
+
+    // Alt + Tab döngüsü sırasında geçmiş değişmez, döngü bitince güncellenir
+    if (c && c->workspace >= 0 && !focus_cycling)
+        focus_history_push(&workspaces[c->workspace], c);
 
     // EWMH özelliklerini güncelle
     update_workspace_properties();
 }
 
+// Odağı bırak (odaklanacak pencere kalmadı); giriş odağı köke döner
+void clear_focus()
+{
+    if (pending_focus != None)
+    {
+        timer_cancel(TIMER_FOCUS);
+        pending_focus = None;
+    }
+    if (focused_window == None)
+        return;
+
+    focused_window = None;
+    XSetInputFocus(display, PointerRoot, RevertToPointerRoot, CurrentTime);
+    update_workspace_properties();
+}
+
+// Workspace'te en son odaklanan pencereye odaklan (yoksa odağı bırak)
+void focus_last_in_workspace(int workspace)
+{
+    Client *c = workspaces[workspace].focus_head;
+    if (c)
+        focus_window(c->window);
+    else
+        clear_focus();
+}
+
+// Pencereyi öne getir (klavye, yeni pencere ve etkinleştirme isteği; fare
+// pencere üzerinden geçerken öne getirmez)
+void raise_window(Window window)
+{
+    XRaiseWindow(display, window);
+
+    Client *c = client_find(window);
+    if (c)
+        stack_raise(c);
+}
+
+// Gecikme doldu: fare hâlâ aynı penceredeyse odakla
+void apply_pending_focus()
+{
+    Window window = pending_focus;
+    pending_focus = None;
+
+    Client *c = client_find(window);
+    if (c && workspace_visible(c->workspace))
+        focus_window(window);
+}
+
+// Fareyle odak: fare pencereler üzerinden hızla geçerken her pencere için
+// odak değiştirilmez, fare focus_delay_ms kadar durduğunda bir kez değişir
+void handle_enter_notify(XCrossingEvent *event)
+{
+    if (event->mode != NotifyNormal || is_switching_workspace)
+        return;
+
+    if (event->window == focused_window)
+    {
+        // Odaktaki pencereye geri dönüldü: bekleyen değişim iptal
+        if (pending_focus != None)
+        {
+            timer_cancel(TIMER_FOCUS);
+            pending_focus = None;
+        }
+        stats.focus_noops++;
+        return;
+    }
+
+    if (!client_find(event->window))
+        return;
+
+    if (focus_delay_ms <= 0)
+    {
+        focus_window(event->window);
+        return;
+    }
+
+    if (pending_focus != None)
+        stats.focus_debounced++;
+    pending_focus = event->window;
+    timer_schedule(TIMER_FOCUS, focus_delay_ms, apply_pending_focus);
+}
+
 // Yeni pencere oluşturma isteğini işle
 void handle_map_request(XMapRequestEvent *event)
 {
+    // İstemci kaydını oluştur ve özelliklerini bir kez oku. Özellik
+    // olayları okumadan önce seçilir: arada yapılan değişiklik kaçmasın.
+    if (!client_find(event->window))
+    {
+        Client *c = client_add(event->window);
+        XSelectInput(display, event->window, PropertyChangeMask);
+        client_update_properties(c, None);
+    }
+
     // Önce pencerenin bar olup olmadığını kontrol et
     if (is_bar_window(event->window))
     {
-        // Bar penceresini kaydet ve ekran boyutlarını güncelle
-        bar_window = event->window;
-        bar_exists = 1;
-        update_screen_dimensions_with_bar();
-
         // Bar'ı görünür yap ve yönet
         XMapWindow(display, event->window);
         XSelectInput(display, event->window,
@@ -764,10 +2529,10 @@ void handle_map_request(XMapRequestEvent *event)
         changes.stack_mode = TopIf;
         XConfigureWindow(display, event->window, CWStackMode, &changes);
 
-        // Mevcut pencereleri yeni ekran boyutlarına göre düzenle
-        rearrange_windows();
+        // Dock olarak kaydet; çalışma alanı değiştiyse yerleşimler kirlenir
+        dock_register(client_find(event->window));
 
-        printf("Bar penceresi tanındı ve yapılandırıldı\n");
+        LOG(LOG_INFO, "Bar penceresi tanındı ve yapılandırıldı: %ld", event->window);
         return;
     }
 
@@ -785,6 +2550,18 @@ void handle_map_request(XMapRequestEvent *event)
 
         // Kenarlık kalınlığını ayarla
         XSetWindowBorderWidth(display, event->window, BORDER_WIDTH);
+        grab_client_buttons(event->window);
+
+        // Bilinen geometriyi bir kez oku (sürüklemeler buradan başlar)
+        XWindowAttributes attrs;
+        if (XGetWindowAttributes(display, event->window, &attrs))
+        {
+            Client *c = client_find(event->window);
+            c->x = attrs.x;
+            c->y = attrs.y;
+            c->width = attrs.width;
+            c->height = attrs.height;
+        }
 
         // Pencere için workspace belirle
         int target_workspace = get_workspace_for_window(event->window);
@@ -807,8 +2584,9 @@ void handle_map_request(XMapRequestEvent *event)
 
         // Dialog penceresini otomatik odakla
         focus_window(event->window);
+        raise_window(event->window);
 
-        printf("Dialog penceresi workspace %d'e eklendi: %ld\n", current_workspace + 1, event->window);
+        LOG(LOG_DEBUG, "Dialog penceresi workspace %d'e eklendi: %ld", current_workspace + 1, event->window);
         return;
     }
 
@@ -848,14 +2626,23 @@ void handle_map_request(XMapRequestEvent *event)
 
     // Kenarlık kalınlığını ayarla
     XSetWindowBorderWidth(display, event->window, BORDER_WIDTH);
+    grab_client_buttons(event->window);
+
+    // Bilinen geometri (merkezleme aşağıda günceller)
+    Client *managed = client_find(event->window);
+    managed->x = attrs.x;
+    managed->y = attrs.y;
+    managed->width = attrs.width;
+    managed->height = attrs.height;
 
     // Floating modda veya workspace'teki ilk pencere ise merkeze konumlandır
     if (workspaces[current_workspace].mode == MODE_FLOATING ||
         workspaces[current_workspace].window_count == 0)
     {
-        // Ekran merkezini hesapla
-        int center_x = (screen_width - attrs.width) / 2;
-        int center_y = (screen_height - attrs.height) / 2;
+        // Odaktaki çıkışın merkezini hesapla
+        Monitor *mon = &monitors[current_monitor];
+        int center_x = mon->x + (mon->width - attrs.width) / 2;
+        int center_y = mon->y + (mon->height - attrs.height) / 2;
 
         // Pencereyi merkeze taşı
         XMoveResizeWindow(display, event->window,
@@ -863,6 +2650,8 @@ void handle_map_request(XMapRequestEvent *event)
                           center_y,
                           attrs.width,
                           attrs.height);
+        managed->x = center_x;
+        managed->y = center_y;
     }
     else
     {
@@ -880,41 +2669,50 @@ void handle_map_request(XMapRequestEvent *event)
     // Döşeli modda pencereleri yeniden düzenle
     if (workspaces[current_workspace].mode == MODE_TILING)
     {
-        rearrange_windows();
+        mark_layout_dirty(current_workspace);
     }
 
     // Yeni pencereyi otomatik odakla
     focus_window(event->window);
+    raise_window(event->window);
 
-    printf("Yeni pencere workspace %d'e eklendi: %ld\n", current_workspace + 1, event->window);
-
-    // Pencereye workspace özelliğini ata
-    long desktop = current_workspace;
-    XChangeProperty(display, event->window, _NET_WM_DESKTOP, XA_CARDINAL, 32,
-                    PropModeReplace, (unsigned char *)&desktop, 1);
-
-    // EWMH özelliklerini güncelle
-    update_workspace_properties();
+    LOG(LOG_DEBUG, "Yeni pencere workspace %d'e eklendi: %ld", current_workspace + 1, event->window);
 }
 
 // Pencere tıklama olayını işle
 void handle_button_press(XButtonEvent *event)
 {
-    if (notification_window != None)
+    // Tıklama bildirimi kapatır; pencere ve kaynaklar sonraki gösterim için kalır
+    if (timers[TIMER_NOTIFICATION].deadline != 0)
+    {
+        timer_cancel(TIMER_NOTIFICATION);
+        hide_workspace_notification();
+    }
+    if (event->window == root)
     {
-        XDestroyWindow(display, notification_window);
-        notification_window = None;
+        // Boş bir çıkışa tıklandı: o çıkışı seç
+        if (event->subwindow == None)
+            select_monitor(monitor_at(event->x_root, event->y_root));
+        return;
     }
+
+    // Alt + tık yakalaması: olay penceresi tıklanan istemcidir
+    Client *c = client_find(event->window);
+    if (!c || c->is_dock)
+        return;
+
     if (event->button == Button1)
     { // Sol tık
         // Pencereyi odakla ve taşımaya başla
         focus_window(event->window);
+        raise_window(event->window);
         start_move(event);
     }
     else if (event->button == Button3)
     { // Sağ tık
         // Pencereyi odakla ve boyutlandırmaya başla
         focus_window(event->window);
+        raise_window(event->window);
         start_resize(event);
     }
 }
@@ -922,26 +2720,83 @@ void handle_button_press(XButtonEvent *event)
 // Pencere yok edildiğinde odağı temizle
 void handle_destroy_notify(XDestroyWindowEvent *event)
 {
-    // Bar penceresi yok edildiyse güncelle
-    if (event->window == bar_window)
+    Client *c = client_find(event->window);
+    if (!c)
+        return;
+
+    // Bar penceresi yok edildiyse çalışma alanını güncelle
+    if (c->is_dock)
     {
-        bar_window = None;
-        bar_exists = 0;
-        update_screen_dimensions_with_bar();
-        rearrange_windows();
-        printf("Bar penceresi kaldırıldı\n");
+        dock_unregister(c);
+        client_remove(event->window);
+        LOG(LOG_INFO, "Bar penceresi kaldırıldı: %ld", event->window);
         return;
     }
-    // Pencereyi mevcut workspace'den kaldır
-    remove_window_from_workspace(event->window, current_workspace);
+
+    // Yok edilen pencereye artık istek gönderilmemeli
+    int was_focused = event->window == focused_window;
+    if (was_focused)
+        focused_window = None;
+    if (event->window == pending_focus)
+    {
+        timer_cancel(TIMER_FOCUS);
+        pending_focus = None;
+    }
+
+    // Pencere hangi workspace'teyse oradan kaldır (gizli olanlar dahil)
+    int workspace = c->workspace;
+    unmanage_window(event->window);
+    if (workspace < 0)
+        return;
+
+    // Odaktaki pencere kapandıysa bir öncekine hemen dön
+    if (was_focused && workspace_visible(workspace))
+        focus_last_in_workspace(workspace);
+    else if (was_focused)
+        clear_focus();
 
     // Pencereler kaldırıldıktan sonra yeniden düzenle
-    if (workspaces[current_workspace].mode == MODE_TILING)
+    if (workspaces[workspace].mode == MODE_TILING)
     {
-        rearrange_windows();
+        mark_layout_dirty(workspace);
     }
 
-    printf("Pencere workspace %d'den kaldırıldı: %ld\n", current_workspace + 1, event->window);
+    LOG(LOG_DEBUG, "Pencere workspace %d'den kaldırıldı: %ld", workspace + 1, event->window);
+}
+
+// Önbellekteki istemci özelliğini yenile
+void handle_property_notify(XPropertyEvent *event)
+{
+    Client *c = client_find(event->window);
+    if (!c)
+        return;
+
+    int was_dialog = c->is_dialog;
+    client_update_properties(c, event->atom);
+
+    // Dock strut'u değiştiyse çalışma alanını yeniden hesapla
+    if (c->is_dock && (event->atom == _NET_WM_STRUT_PARTIAL || event->atom == _NET_WM_STRUT))
+    {
+        update_workarea();
+    }
+
+    // Dialog durumu değiştiyse yerleşim değişir
+    if (c->is_dialog != was_dialog && c->workspace >= 0 &&
+        workspaces[c->workspace].mode == MODE_TILING)
+    {
+        mark_layout_dirty(c->workspace);
+    }
+}
+
+// Dock gizlendiğinde ayırdığı alanı serbest bırak
+void handle_unmap_notify(XUnmapEvent *event)
+{
+    Client *c = client_find(event->window);
+    if (c && c->is_dock && c->dock_mapped)
+    {
+        c->dock_mapped = 0;
+        update_workarea();
+    }
 }
 
 // Pencere yapılandırma değişikliklerini işle
@@ -959,7 +2814,32 @@ void handle_configure_request(XConfigureRequestEvent *event)
     changes.stack_mode = event->detail;
 
     XConfigureWindow(display, event->window, event->value_mask, &changes);
-    printf("Pencere yapılandırması güncellendi: %ld\n", event->window);
+
+    if (event->value_mask & (CWX | CWY | CWWidth | CWHeight))
+        client_forget_geometry(event->window);
+
+    // Kardeşe göre olmayan yığın isteklerini yığın gölgesine yansıt
+    Client *c = client_find(event->window);
+    if (c && (event->value_mask & CWStackMode) && !(event->value_mask & CWSibling))
+    {
+        if (event->detail == Above)
+            stack_raise(c);
+        else if (event->detail == Below)
+            stack_lower(c);
+    }
+    LOG(LOG_DEBUG, "Pencere yapılandırması güncellendi: %ld", event->window);
+}
+
+// Başlangıçta başka bir pencere yöneticisinin çalışıp çalışmadığını yakalar
+static int other_wm_running = 0;
+
+int startup_error_handler(Display *display, XErrorEvent *e)
+{
+    if (e->request_code == X_ChangeWindowAttributes && e->error_code == BadAccess)
+    {
+        other_wm_running = 1;
+    }
+    return 0;
 }
 
 // Hata işleyici
@@ -967,61 +2847,197 @@ int error_handler(Display *display, XErrorEvent *e)
 {
     char error_text[256];
     XGetErrorText(display, e->error_code, error_text, sizeof(error_text));
-    fprintf(stderr, "X Hatası: %s\n", error_text);
+    LOG(LOG_ERROR, "X Hatası: %s", error_text);
+    return 0;
+}
+
+// Pencere çerçeveyle mi sürüklenmeli: workspace ayarı veya sınıf listesi
+static int drag_uses_outline(Client *c)
+{
+    if (c->workspace >= 0 && workspaces[c->workspace].outline_drag)
+        return 1;
+    if (!c->class_name)
+        return 0;
+    for (int i = 0; outline_classes[i] != NULL; i++)
+    {
+        if (strcmp(c->class_name, outline_classes[i]) == 0)
+            return 1;
+    }
     return 0;
 }
 
+// Çerçeveyi kökte XOR ile çiz; aynı dikdörtgeni yeniden çizmek onu siler.
+// Dış kenar pencerenin kenarlığıyla çakışır.
+static void draw_outline(int x, int y, int width, int height)
+{
+    XDrawRectangle(display, root, outline_gc, x, y,
+                   width + 2 * BORDER_WIDTH - 1,
+                   height + 2 * BORDER_WIDTH - 1);
+}
+
+// Çizili çerçeveyi yeni dikdörtgene taşı
+static void move_outline(int x, int y, int width, int height)
+{
+    if (outline_drawn)
+        draw_outline(outline_x, outline_y, outline_width, outline_height);
+    outline_x = x;
+    outline_y = y;
+    outline_width = width;
+    outline_height = height;
+    draw_outline(x, y, width, height);
+    outline_drawn = 1;
+}
+
+// Sürüklemeyi başlat. Düğme yakalaması zaten etkin; yalnızca imleç ve olay
+// maskesi değiştirilir. Başlangıç geometrisi pencere yöneticisinin bildiği
+// değerlerdir, sunucuya gidiş-dönüş yapılmaz.
+static void start_drag(XButtonEvent *event, int resize)
+{
+    Client *c = client_find(event->window);
+    if (!c)
+        return;
+
+    dragging_window = c->window;
+    resize_mode = resize;
+    start_x = event->x_root;
+    start_y = event->y_root;
+    orig_x = c->x;
+    orig_y = c->y;
+    orig_width = c->width;
+    orig_height = c->height;
+    drag_pending = 0;
+    drag_last_apply = 0;
+
+    XChangeActivePointerGrab(display, ButtonMotionMask | ButtonReleaseMask,
+                             resize ? resize_cursor : move_cursor, CurrentTime);
+
+    // Çerçeve modunda istemci bırakılana kadar yapılandırılmaz. Altta kalan
+    // pencerelerin yeniden çizimi XOR çerçeveyi bozmasın diye sunucu kilitlenir.
+    outline_mode = drag_uses_outline(c);
+    if (outline_mode)
+    {
+        XGrabServer(display);
+        move_outline(orig_x, orig_y, orig_width, orig_height);
+    }
+}
+
 // Pencereyi taşımaya başla
 void start_move(XButtonEvent *event)
 {
-    Window returned_root, returned_parent;
-    Window *children;
-    unsigned int nchildren;
-    XWindowAttributes attrs;
+    start_drag(event, 0);
+}
+
+// Pencereyi boyutlandırmaya başla
+void start_resize(XButtonEvent *event)
+{
+    start_drag(event, 1);
+}
+
+// WM_NORMAL_HINTS'taki minimum/maksimum boyutu uygular
+void client_apply_size_hints(Client *c, int *width, int *height)
+{
+    const XSizeHints *h = &c->size_hints;
 
-    // Tıklanan noktadaki pencereyi bul
-    XQueryTree(display, root, &returned_root, &returned_parent, &children, &nchildren);
-    if (children)
+    if (h->flags & PMinSize)
+    {
+        if (*width < h->min_width)
+            *width = h->min_width;
+        if (*height < h->min_height)
+            *height = h->min_height;
+    }
+    if (h->flags & PMaxSize)
     {
-        dragging_window = children[nchildren - 1]; // En üstteki pencere
-        XFree(children);
+        if (h->max_width > 0 && *width > h->max_width)
+            *width = h->max_width;
+        if (h->max_height > 0 && *height > h->max_height)
+            *height = h->max_height;
     }
+}
 
-    if (dragging_window != None)
+// Sürüklenen pencereye verilen fare konumuna göre geometri uygula
+void apply_drag(int x_root, int y_root)
+{
+    int xdiff = x_root - start_x;
+    int ydiff = y_root - start_y;
+    int x = orig_x, y = orig_y;
+    int width = orig_width, height = orig_height;
+
+    if (resize_mode)
+    {
+        // Boyutlandırma
+        width = orig_width + xdiff;
+        height = orig_height + ydiff;
+
+        // Minimum boyut kontrolü
+        if (width < 100)
+            width = 100;
+        if (height < 100)
+            height = 100;
+
+        Client *c = client_find(dragging_window);
+        if (c)
+            client_apply_size_hints(c, &width, &height);
+    }
+    else
     {
-        XGetWindowAttributes(display, dragging_window, &attrs);
-        start_x = event->x_root;
-        start_y = event->y_root;
-        orig_x = attrs.x;
-        orig_y = attrs.y;
-        orig_width = attrs.width;
-        orig_height = attrs.height;
+        // Taşıma
+        x = orig_x + xdiff;
+        y = orig_y + ydiff;
+    }
 
-        // Fare ikonunu değiştir
-        Cursor cursor = XCreateFontCursor(display, XC_fleur);
-        XGrabPointer(display, root, True,
-                     ButtonMotionMask | ButtonReleaseMask,
-                     GrabModeAsync, GrabModeAsync,
-                     root, cursor, CurrentTime);
-        XFreeCursor(display, cursor);
+    if (outline_mode)
+    {
+        // Yalnızca çerçeve güncellenir; istemci stop_drag'de yapılandırılır
+        move_outline(x, y, width, height);
+    }
+    else
+    {
+        Client *c = client_find(dragging_window);
+        if (resize_mode && c)
+        {
+            // İstemci önceki boyutu çizmediyse bekletilir
+            client_configure(c, x, y, width, height);
+        }
+        else
+        {
+            XMoveWindow(display, dragging_window, x, y);
+            if (c && c->sync_held)
+            {
+                // Bekleyen boyutlandırma pencereyi eski konuma geri götürmesin
+                c->held_x = x;
+                c->held_y = y;
+            }
+        }
+        client_forget_geometry(dragging_window);
     }
+
+    drag_pending = 0;
+    drag_last_apply = now_ms();
+    stats.drag_updates++;
 }
 
-// Pencereyi boyutlandırmaya başla
-void start_resize(XButtonEvent *event)
+// Bekleyen sürükleme güncellemesini uygula (zamanlayıcı tarafından çağrılır)
+void flush_drag()
 {
-    start_move(event); // Aynı başlangıç işlemleri
-    if (dragging_window != None)
+    if (dragging_window != None && drag_pending)
+    {
+        apply_drag(drag_x, drag_y);
+    }
+}
+
+// Kuyrukta sürüklenen pencerenin hareket olayı mı. Bırakmadan sonraki
+// hareketler sürüklemeye ait değildir: ButtonRelease görülünce tarama durur.
+static Bool is_drag_motion(Display *display, XEvent *event, XPointer arg)
+{
+    int *release_seen = (int *)arg;
+    if (*release_seen)
+        return False;
+    if (event->type == ButtonRelease)
     {
-        resize_mode = 1;
-        // Boyutlandırma için fare ikonunu değiştir
-        Cursor cursor = XCreateFontCursor(display, XC_sizing);
-        XGrabPointer(display, root, True,
-                     ButtonMotionMask | ButtonReleaseMask,
-                     GrabModeAsync, GrabModeAsync,
-                     root, cursor, CurrentTime);
-        XFreeCursor(display, cursor);
+        *release_seen = 1;
+        return False;
     }
+    return event->type == MotionNotify && event->xmotion.window == dragging_window;
 }
 
 // Fare hareketi işleme
@@ -1029,29 +3045,37 @@ void handle_motion(XMotionEvent *event)
 {
     if (dragging_window != None)
     {
-        int xdiff = event->x_root - start_x;
-        int ydiff = event->y_root - start_y;
+        drag_x = event->x_root;
+        drag_y = event->y_root;
 
-        if (resize_mode)
+        // Kuyrukta bekleyen hareket olaylarını en sonuncusuna indir
+        XEvent next;
+        int release_seen = 0;
+        while (XCheckIfEvent(display, &next, is_drag_motion, (XPointer)&release_seen))
         {
-            // Boyutlandırma
-            int new_width = orig_width + xdiff;
-            int new_height = orig_height + ydiff;
+            drag_x = next.xmotion.x_root;
+            drag_y = next.xmotion.y_root;
+            stats.motion_coalesced++;
+        }
+        drag_pending = 1;
 
-            // Minimum boyut kontrolü
-            if (new_width < 100)
-                new_width = 100;
-            if (new_height < 100)
-                new_height = 100;
+        if (drag_rate_hz <= 0)
+        {
+            apply_drag(drag_x, drag_y);
+            return;
+        }
 
-            XResizeWindow(display, dragging_window, new_width, new_height);
+        // Kare hızı sınırı: erken gelen hareketi bir sonraki kareye ertele
+        unsigned long interval = 1000 / drag_rate_hz;
+        unsigned long elapsed = now_ms() - drag_last_apply;
+        if (elapsed >= interval)
+        {
+            timer_cancel(TIMER_DRAG);
+            apply_drag(drag_x, drag_y);
         }
-        else
+        else if (timers[TIMER_DRAG].deadline == 0)
         {
-            // Taşıma
-            XMoveWindow(display, dragging_window,
-                        orig_x + xdiff,
-                        orig_y + ydiff);
+            timer_schedule(TIMER_DRAG, interval - elapsed, flush_drag);
         }
     }
     else if (is_switching_workspace)
@@ -1066,6 +3090,23 @@ void stop_drag(XButtonEvent *event)
 {
     if (dragging_window != None)
     {
+        // Son konumu her zaman uygula
+        timer_cancel(TIMER_DRAG);
+        apply_drag(event->x_root, event->y_root);
+
+        if (outline_mode)
+        {
+            // Çerçeveyi sil ve istemciye tek bir yapılandırma gönder
+            draw_outline(outline_x, outline_y, outline_width, outline_height);
+            outline_drawn = 0;
+            XUngrabServer(display);
+            Client *c = client_find(dragging_window);
+            if (c)
+                client_configure(c, outline_x, outline_y, outline_width, outline_height);
+            client_forget_geometry(dragging_window);
+            outline_mode = 0;
+        }
+
         XUngrabPointer(display, CurrentTime);
         dragging_window = None;
         resize_mode = 0;
@@ -1080,6 +3121,10 @@ void exec_command(const char *cmd)
     if (pid == 0)
     {
         // Çocuk süreçte komutu çalıştır
+        // (SIGUSR1/2 ana süreçte signalfd için bloklu, çocuklara miras kalmasın)
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigprocmask(SIG_SETMASK, &mask, NULL);
         setsid();
         system(cmd);
         exit(EXIT_SUCCESS);
@@ -1095,21 +3140,11 @@ void close_window(Window window)
         return;
     }
 
-    // Pencere mevcut workspace'te mi kontrol et
-    int window_in_current_workspace = 0;
-    for (int i = 0; i < workspaces[current_workspace].window_count; i++)
-    {
-        if (workspaces[current_workspace].windows[i] == window)
-        {
-            window_in_current_workspace = 1;
-            break;
-        }
-    }
-
-    // Eğer pencere mevcut workspace'te değilse işlem yapma
-    if (!window_in_current_workspace)
+    // Eğer pencere görünen bir workspace'te değilse işlem yapma
+    Client *c = client_find(window);
+    if (!c || !workspace_visible(c->workspace))
     {
-        printf("Pencere %ld mevcut workspace'te değil, kapatma işlemi iptal edildi\n", window);
+        LOG(LOG_DEBUG, "Pencere %ld görünen bir workspace'te değil, kapatma işlemi iptal edildi", window);
         return;
     }
 
@@ -1118,21 +3153,21 @@ void close_window(Window window)
     memset(&ev, 0, sizeof(ev));
     ev.type = ClientMessage;
     ev.xclient.window = window;
-    ev.xclient.message_type = XInternAtom(display, "WM_PROTOCOLS", False);
+    ev.xclient.message_type = WM_PROTOCOLS;
     ev.xclient.format = 32;
-    ev.xclient.data.l[0] = XInternAtom(display, "WM_DELETE_WINDOW", False);
+    ev.xclient.data.l[0] = WM_DELETE_WINDOW;
     ev.xclient.data.l[1] = CurrentTime;
 
     XSendEvent(display, window, False, NoEventMask, &ev);
-    printf("Pencere kapatma isteği gönderildi: %ld (Workspace %d)\n",
-           window, current_workspace + 1);
+    LOG(LOG_DEBUG, "Pencere kapatma isteği gönderildi: %ld (Workspace %d)",
+           window, c->workspace + 1);
 }
 
 // Pencereyi başka bir workspace'e taşı
 void move_window_to_workspace(Window window, int from_ws, int to_ws)
 {
-    if (from_ws < 0 || from_ws >= NUM_WORKSPACES ||
-        to_ws < 0 || to_ws >= NUM_WORKSPACES ||
+    if (from_ws < 0 || from_ws >= num_workspaces ||
+        to_ws < 0 || to_ws >= num_workspaces ||
         from_ws == to_ws || window == None)
     {
         return;
@@ -1144,61 +3179,38 @@ void move_window_to_workspace(Window window, int from_ws, int to_ws)
     // Pencereyi yeni workspace'e ekle
     add_window_to_workspace(window, to_ws);
 
-    // Pencerenin _NET_WM_DESKTOP özelliğini güncelle
-    long desktop = to_ws;
-    XChangeProperty(display, window, _NET_WM_DESKTOP, XA_CARDINAL, 32,
-                    PropModeReplace, (unsigned char *)&desktop, 1);
-
-    // Aktif workspace değiştiyse, pencereyi sakla/göster
-    if (current_workspace != to_ws)
+    // Hedef workspace görünmüyorsa pencereyi sakla, görünüyorsa göster
+    Client *c = client_find(window);
+    if (c && !workspace_visible(to_ws))
     {
-        XUnmapWindow(display, window);
+        client_hide(c);
+
+        // Gizlenen pencere odaktaysa kaynak workspace'te bir öncekine dön
+        if (window == focused_window)
+        {
+            if (workspace_visible(from_ws))
+                focus_last_in_workspace(from_ws);
+            else
+                clear_focus();
+        }
     }
-    else
+    else if (c)
     {
-        XMapWindow(display, window);
+        client_show(c);
     }
 
     // Her workspace'in kendi moduna göre düzenleme yap
     if (workspaces[from_ws].mode == MODE_TILING)
     {
-        // Geçici olarak workspace'i değiştir ve düzenle
-        int temp_ws = current_workspace;
-        current_workspace = from_ws;
-        rearrange_windows();
-        current_workspace = temp_ws;
+        mark_layout_dirty(from_ws);
     }
 
-    if (workspaces[to_ws].mode == MODE_TILING && to_ws != from_ws)
-    {
-        // Geçici olarak workspace'i değiştir ve düzenle
-        int temp_ws = current_workspace;
-        current_workspace = to_ws;
-        rearrange_windows();
-        current_workspace = temp_ws;
-    }
-
-    // EWMH özelliklerini güncelle
-    update_workspace_properties();
-
-    // Pencere listesini güncelle
-    Window client_list[MAX_WINDOWS * NUM_WORKSPACES];
-    int client_count = 0;
-
-    // Tüm workspace'lerdeki pencereleri topla
-    for (int i = 0; i < NUM_WORKSPACES; i++)
+    if (workspaces[to_ws].mode == MODE_TILING)
     {
-        for (int j = 0; j < workspaces[i].window_count; j++)
-        {
-            client_list[client_count++] = workspaces[i].windows[j];
-        }
+        mark_layout_dirty(to_ws);
     }
 
-    // _NET_CLIENT_LIST özelliğini güncelle
-    XChangeProperty(display, root, _NET_CLIENT_LIST, XA_WINDOW, 32,
-                    PropModeReplace, (unsigned char *)client_list, client_count);
-
-    printf("Pencere %ld workspace %d'den %d'e taşındı\n",
+    LOG(LOG_DEBUG, "Pencere %ld workspace %d'den %d'e taşındı",
            window, from_ws + 1, to_ws + 1);
 }
 
@@ -1207,6 +3219,10 @@ void handle_key_press(XKeyEvent *event)
 {
     KeySym keysym = XkbKeycodeToKeysym(display, event->keycode, 0, 0);
 
+    // Alt bırakılmış ama döngü bitmemişse (kaçırılan bırakma) şimdi bitir
+    if (focus_cycling && !(event->state & MODKEY))
+        end_focus_cycle();
+
     // Alt+Shift kombinasyonlarını kontrol et
     if ((event->state & MODKEY) && (event->state & ShiftMask))
     {
@@ -1216,14 +3232,14 @@ void handle_key_press(XKeyEvent *event)
             if (focused_window != None)
             {
                 int target_workspace = keysym - XK_1;
-                printf("Alt + Shift + %d tuşuna basıldı\n", target_workspace + 1);
+                LOG(LOG_DEBUG, "Alt + Shift + %d tuşuna basıldı", target_workspace + 1);
                 move_window_to_workspace(focused_window, current_workspace, target_workspace);
             }
         }
         else if (event->keycode == keys.return_key)
         {
             // Alt + Shift + Enter: Terminal aç
-            printf("Terminal açılıyor...\n");
+            LOG(LOG_DEBUG, "Terminal açılıyor...");
             exec_command(TERMINAL);
         }
         else if (event->keycode == keys.k_key)
@@ -1249,6 +3265,7 @@ void handle_key_press(XKeyEvent *event)
                 XWindowAttributes attrs;
                 XGetWindowAttributes(display, focused_window, &attrs);
                 XMoveWindow(display, focused_window, attrs.x - 10, attrs.y);
+                client_forget_geometry(focused_window);
             }
         }
         else if (event->keycode == keys.right_key)
@@ -1259,6 +3276,7 @@ void handle_key_press(XKeyEvent *event)
                 XWindowAttributes attrs;
                 XGetWindowAttributes(display, focused_window, &attrs);
                 XMoveWindow(display, focused_window, attrs.x + 10, attrs.y);
+                client_forget_geometry(focused_window);
             }
         }
         else if (event->keycode == keys.up_key)
@@ -1269,6 +3287,7 @@ void handle_key_press(XKeyEvent *event)
                 XWindowAttributes attrs;
                 XGetWindowAttributes(display, focused_window, &attrs);
                 XMoveWindow(display, focused_window, attrs.x, attrs.y - 10);
+                client_forget_geometry(focused_window);
             }
         }
         else if (event->keycode == keys.down_key)
@@ -1279,6 +3298,7 @@ void handle_key_press(XKeyEvent *event)
                 XWindowAttributes attrs;
                 XGetWindowAttributes(display, focused_window, &attrs);
                 XMoveWindow(display, focused_window, attrs.x, attrs.y + 10);
+                client_forget_geometry(focused_window);
             }
         }
     }
@@ -1289,13 +3309,13 @@ void handle_key_press(XKeyEvent *event)
         {
             // Alt + 1-9: Workspace değiştir
             int workspace = keysym - XK_1;
-            printf("Alt + %d tuşuna basıldı\n", workspace + 1);
+            LOG(LOG_DEBUG, "Alt + %d tuşuna basıldı", workspace + 1);
             switch_workspace(workspace);
         }
         else if (event->keycode == keys.d_key)
         {
             // Alt + d: dmenu çalıştır
-            printf("dmenu çalıştırılıyor...\n");
+            LOG(LOG_DEBUG, "dmenu çalıştırılıyor...");
             exec_command(LAUNCHER);
         }
         else if (event->keycode == keys.q_key)
@@ -1312,6 +3332,36 @@ void handle_key_press(XKeyEvent *event)
             // Alt + t: Tiling modunu değiştir
             toggle_tiling_mode();
         }
+        else if (event->keycode == keys.comma_key)
+        {
+            // Alt + ,: Önceki çıkışa geç
+            focus_monitor(-1);
+        }
+        else if (event->keycode == keys.period_key)
+        {
+            // Alt + .: Sonraki çıkışa geç
+            focus_monitor(1);
+        }
+        else if (event->keycode == keys.space_key)
+        {
+            // Alt + Space: Sonraki yerleşime geç
+            cycle_layout();
+        }
+        else if (event->keycode == keys.i_key)
+        {
+            // Alt + i: Ana bölgeye bir pencere ekle
+            adjust_nmaster(1);
+        }
+        else if (event->keycode == keys.u_key)
+        {
+            // Alt + u: Ana bölgeden bir pencere çıkar
+            adjust_nmaster(-1);
+        }
+        else if (event->keycode == keys.o_key)
+        {
+            // Alt + o: Bu workspace'te çerçeveyle sürüklemeyi aç/kapat
+            toggle_outline_drag();
+        }
         else if (event->keycode == keys.h_key)
         {
             // Alt + h: Ana bölgeyi %1 daralt (sola doğru)
@@ -1345,13 +3395,13 @@ void handle_key_press(XKeyEvent *event)
         else if (event->keycode == keys.left_key)
         {
             // Alt + Sol: Önceki workspace'e git
-            int prev_workspace = (current_workspace - 1 + NUM_WORKSPACES) % NUM_WORKSPACES;
+            int prev_workspace = (current_workspace - 1 + num_workspaces) % num_workspaces;
             switch_workspace(prev_workspace);
         }
         else if (event->keycode == keys.right_key)
         {
             // Alt + Sağ: Sonraki workspace'e git
-            int next_workspace = (current_workspace + 1) % NUM_WORKSPACES;
+            int next_workspace = (current_workspace + 1) % num_workspaces;
             switch_workspace(next_workspace);
         }
         else if (event->keycode == keys.tab_key)
@@ -1377,12 +3427,22 @@ void handle_key_press(XKeyEvent *event)
     }
 }
 
+// Boşluklar tüm workspace'ler için ortaktır; gizliler gösterilince düzenlenir
+void mark_all_layouts_dirty()
+{
+    for (int i = 0; i < num_workspaces; i++)
+    {
+        if (workspaces[i].mode == MODE_TILING)
+            mark_layout_dirty(i);
+    }
+}
+
 // Boşlukları aç/kapa
 void toggle_gaps()
 {
     gaps_enabled = !gaps_enabled;
-    printf("Boşluklar %s\n", gaps_enabled ? "açıldı" : "kapatıldı");
-    rearrange_windows();
+    LOG(LOG_INFO, "Boşluklar %s", gaps_enabled ? "açıldı" : "kapatıldı");
+    mark_all_layouts_dirty();
 }
 
 // Boşluk boyutlarını ayarla
@@ -1405,39 +3465,60 @@ void adjust_gaps(int outer_delta, int inner_delta)
     if (inner_gap > 50)
         inner_gap = 50;
 
-    printf("Boşluklar güncellendi - Dış: %d, İç: %d\n", outer_gap, inner_gap);
-    rearrange_windows();
+    LOG(LOG_INFO, "Boşluklar güncellendi - Dış: %d, İç: %d", outer_gap, inner_gap);
+    mark_all_layouts_dirty();
 }
 
-// Workspace içinde bir sonraki pencereye geç
+// Alt + Tab: odak geçmişinde bir sonraki (daha eski) pencereye geç (O(1)).
+// Alt basılı kaldıkça geçmiş değişmez; Alt bırakılınca seçilen pencere
+// geçmişin başına alınır (end_focus_cycle).
 void focus_next_window()
 {
     Workspace *ws = &workspaces[current_workspace];
     if (ws->window_count <= 1)
         return; // Tek pencere varsa işlem yapma
 
-    // Mevcut odaklanmış pencerenin indeksini bul
-    int current_index = -1;
-    for (int i = 0; i < ws->window_count; i++)
-    {
-        if (ws->windows[i] == focused_window)
-        {
-            current_index = i;
-            break;
-        }
-    }
+    // Alt'ın bırakılması, başlangıçta seçilen XkbStateNotify ile görülür;
+    // döngü için klavye yakalanmaz ve sunucuya soru sorulmaz
+    focus_cycling = 1;
 
     // Bir sonraki pencereyi hesapla (döngüsel olarak)
-    int next_index = (current_index + 1) % ws->window_count;
+    Client *c = client_find(focused_window);
+    Client *next = (c && c->workspace == current_workspace && c->focus_next) ? c->focus_next : ws->focus_head;
 
     // Yeni pencereye odaklan
-    focus_window(ws->windows[next_index]);
+    Window previous = focused_window;
+    focus_window(next->window);
+    raise_window(next->window);
+
+    LOG(LOG_DEBUG, "Pencere odağı değiştirildi: %ld -> %ld",
+           previous, next->window);
+}
+
+// Alt bırakıldı: döngüde seçilen pencereyi geçmişin başına al
+void end_focus_cycle()
+{
+    if (!focus_cycling)
+        return;
+
+    focus_cycling = 0;
+
+    Client *c = client_find(focused_window);
+    if (c && c->workspace >= 0)
+        focus_history_push(&workspaces[c->workspace], c);
+}
 
-    printf("Pencere odağı değiştirildi: %ld -> %ld\n",
-           ws->windows[current_index], ws->windows[next_index]);
+// Tuş bırakma: yalnızca Alt + Tab döngüsünün bitişi için dinlenir
+void handle_key_release(XKeyEvent *event)
+{
+    KeySym keysym = XkbKeycodeToKeysym(display, event->keycode, 0, 0);
+    if (focus_cycling && (keysym == XK_Alt_L || keysym == XK_Alt_R))
+        end_focus_cycle();
 }
 
-// Bildirim penceresini oluştur
+// Bildirim penceresini ve çizim kaynaklarını oluştur. Tüm workspace
+// numaraları bir pixmap'e bir kez çizilir; gösterim ve Expose yalnızca
+// ilgili hücreyi kopyalar, yazı tipi yükleme gidiş-dönüşü tekrarlanmaz.
 void create_notification_window()
 {
     XSetWindowAttributes attrs;
@@ -1445,95 +3526,152 @@ void create_notification_window()
     attrs.background_pixel = WS_NOTIFICATION_BG;
     attrs.border_pixel = WS_NOTIFICATION_BORDER;
 
-    // Ekran ortasında konumlandır
-    int width = 100;
-    int height = 50;
-    int x = (screen_width - width) / 2;
-    int y = (screen_height - height) / 2;
-
+    // Konum ve boyut her gösterimde odaktaki çıkışa göre ayarlanır
+    int screen = DefaultScreen(display);
     notification_window = XCreateWindow(display, root,
-                                        x, y, width, height,
+                                        0, 0, 100, 50,
                                         2, // border width
-                                        DefaultDepth(display, DefaultScreen(display)),
+                                        DefaultDepth(display, screen),
                                         CopyFromParent,
-                                        DefaultVisual(display, DefaultScreen(display)),
+                                        DefaultVisual(display, screen),
                                         CWOverrideRedirect | CWBackPixel | CWBorderPixel,
                                         &attrs);
 
     XSelectInput(display, notification_window, ExposureMask);
-}
 
-// Bildirim penceresini göster
-void show_workspace_notification(int workspace_num)
-{
-    if (notification_window == None)
+    notification_font = XLoadQueryFont(display, "fixed");
+    if (!notification_font)
     {
-        create_notification_window();
+        LOG(LOG_WARN, "Bildirim yazı tipi yüklenemedi");
+        return;
     }
 
-    // Pencereyi göster
-    XMapRaised(display, notification_window);
+    // Hücre, en geniş numaraya göre
+    char text[16];
+    notification_cell_width = 1;
+    for (int i = 0; i < MAX_WORKSPACES; i++)
+    {
+        snprintf(text, sizeof(text), "%d", i + 1);
+        int width = XTextWidth(notification_font, text, strlen(text));
+        if (width > notification_cell_width)
+            notification_cell_width = width;
+    }
+    notification_cell_height = notification_font->ascent + notification_font->descent;
 
-    // Pencereyi çiz
     XGCValues values;
-    GC gc = XCreateGC(display, notification_window, 0, &values);
-    XSetForeground(display, gc, WS_NOTIFICATION_FG);
+    values.font = notification_font->fid;
+    values.graphics_exposures = False;
+    notification_gc = XCreateGC(display, notification_window,
+                                GCFont | GCGraphicsExposures, &values);
+
+    notification_digits = XCreatePixmap(display, notification_window,
+                                        notification_cell_width * MAX_WORKSPACES,
+                                        notification_cell_height,
+                                        DefaultDepth(display, screen));
+    XSetForeground(display, notification_gc, WS_NOTIFICATION_BG);
+    XFillRectangle(display, notification_digits, notification_gc, 0, 0,
+                   notification_cell_width * MAX_WORKSPACES, notification_cell_height);
+    XSetForeground(display, notification_gc, WS_NOTIFICATION_FG);
+    for (int i = 0; i < MAX_WORKSPACES; i++)
+    {
+        snprintf(text, sizeof(text), "%d", i + 1);
+        int width = XTextWidth(notification_font, text, strlen(text));
+        XDrawString(display, notification_digits, notification_gc,
+                    i * notification_cell_width + (notification_cell_width - width) / 2,
+                    notification_font->ascent, text, strlen(text));
+    }
+}
+
+// Bildirim boyutu: çıkışın yaklaşık 1/16'sı, en az 100x50
+static void notification_size(Monitor *mon, int *width, int *height)
+{
+    *width = mon->width / 16 > 100 ? mon->width / 16 : 100;
+    *height = mon->height / 16 > 50 ? mon->height / 16 : 50;
+}
 
-    char text[32];
-    snprintf(text, sizeof(text), "%d", workspace_num + 1);
+// Önceden çizilmiş numarayı pencerenin ortasına kopyala
+void draw_workspace_notification()
+{
+    if (notification_digits == None)
+        return;
+
+    XCopyArea(display, notification_digits, notification_window, notification_gc,
+              notification_workspace * notification_cell_width, 0,
+              notification_cell_width, notification_cell_height,
+              (notification_width - notification_cell_width) / 2,
+              (notification_height - notification_cell_height) / 2);
+}
 
-    // Metni ortala
-    XFontStruct *font = XLoadQueryFont(display, "fixed");
-    if (font)
+// Bildirim penceresini göster
+void show_workspace_notification(int workspace_num)
+{
+    if (notification_window == None)
     {
-        XSetFont(display, gc, font->fid);
-        int text_width = XTextWidth(font, text, strlen(text));
-        int x = (100 - text_width) / 2;                    // 100 = window width
-        int y = (50 + (font->ascent - font->descent)) / 2; // 50 = window height
-        XDrawString(display, notification_window, gc, x, y, text, strlen(text));
-        XFreeFont(display, font);
+        create_notification_window();
     }
 
-    XFreeGC(display, gc);
-    XFlush(display);
+    // Odaktaki çıkışın ortasında, çıkışa göre boyutlanmış olarak göster
+    Monitor *mon = &monitors[current_monitor];
+    notification_size(mon, &notification_width, &notification_height);
+    XMoveResizeWindow(display, notification_window,
+                      mon->x + (mon->width - notification_width) / 2,
+                      mon->y + (mon->height - notification_height) / 2,
+                      notification_width, notification_height);
+    XMapRaised(display, notification_window);
+
+    // Zaten görünürse Expose gelmez; yeni numarayı hemen kopyala
+    notification_workspace = workspace_num;
+    XClearWindow(display, notification_window);
+    draw_workspace_notification();
 
     // Zamanlayıcı ayarla
-    struct timeval current_time;
-    gettimeofday(&current_time, NULL);
-    popup_timer = (current_time.tv_sec * 1000) + (current_time.tv_usec / 1000);
+    timer_schedule(TIMER_NOTIFICATION, notification_timeout, hide_workspace_notification);
 }
 
-// Bildirim penceresini kontrol et
-void check_notification_timeout()
+// Bildirim penceresini gizle (zamanlayıcı tarafından çağrılır)
+void hide_workspace_notification()
 {
-    if (notification_window == None || popup_timer == 0)
-        return;
-
-    struct timeval current_time;
-    gettimeofday(&current_time, NULL);
-    unsigned long current_ms = (current_time.tv_sec * 1000) + (current_time.tv_usec / 1000);
-
-    if (current_ms - popup_timer >= notification_timeout)
+    if (notification_window != None)
     {
         XUnmapWindow(display, notification_window);
-        popup_timer = 0;
     }
 }
 
+// Bildirim kaynaklarını serbest bırak (çıkışta)
+void free_workspace_notification()
+{
+    if (notification_window == None)
+        return;
+    if (notification_digits != None)
+        XFreePixmap(display, notification_digits);
+    if (notification_gc)
+        XFreeGC(display, notification_gc);
+    if (notification_font)
+        XFreeFont(display, notification_font);
+    XDestroyWindow(display, notification_window);
+    notification_window = None;
+}
+
 void init_atoms()
 {
-    _NET_WM_WINDOW_TYPE = XInternAtom(display, "_NET_WM_WINDOW_TYPE", False);
-    _NET_WM_WINDOW_TYPE_DOCK = XInternAtom(display, "_NET_WM_WINDOW_TYPE_DOCK", False);
-    _NET_WM_DESKTOP = XInternAtom(display, "_NET_WM_DESKTOP", False);
-    _NET_CURRENT_DESKTOP = XInternAtom(display, "_NET_CURRENT_DESKTOP", False);
-    _NET_NUMBER_OF_DESKTOPS = XInternAtom(display, "_NET_NUMBER_OF_DESKTOPS", False);
-    _NET_CLIENT_LIST = XInternAtom(display, "_NET_CLIENT_LIST", False);
-    _NET_ACTIVE_WINDOW = XInternAtom(display, "_NET_ACTIVE_WINDOW", False);
-    _NET_WM_STRUT_PARTIAL = XInternAtom(display, "_NET_WM_STRUT_PARTIAL", False);
-    _NET_WM_STRUT = XInternAtom(display, "_NET_WM_STRUT", False);
-    _NET_WM_STATE = XInternAtom(display, "_NET_WM_STATE", False);
-    _NET_WM_STATE_DEMANDS_ATTENTION = XInternAtom(display, "_NET_WM_STATE_DEMANDS_ATTENTION", False);
-    _NET_SUPPORTED = XInternAtom(display, "_NET_SUPPORTED", False);
+    char *names[ATOM_COUNT];
+    Atom values[ATOM_COUNT];
+
+    for (unsigned int i = 0; i < ATOM_COUNT; i++)
+    {
+        names[i] = (char *)atom_table[i].name;
+    }
+
+    // Tüm atomlar için tek gidiş-dönüş
+    if (!XInternAtoms(display, names, ATOM_COUNT, False, values))
+    {
+        LOG(LOG_WARN, "Bazı atomlar alınamadı");
+    }
+
+    for (unsigned int i = 0; i < ATOM_COUNT; i++)
+    {
+        *atom_table[i].atom = values[i];
+    }
 }
 
 void set_supported_hints()
@@ -1547,7 +3685,13 @@ void set_supported_hints()
         _NET_CLIENT_LIST,
         _NET_ACTIVE_WINDOW,
         _NET_WM_WINDOW_TYPE,
-        _NET_WM_WINDOW_TYPE_DOCK};
+        _NET_WM_WINDOW_TYPE_DOCK,
+        _NET_CLIENT_LIST_STACKING,
+        _NET_WORKAREA,
+        _NET_DESKTOP_NAMES,
+        _NET_DESKTOP_VIEWPORT,
+        _NET_WM_SYNC_REQUEST,
+        _NET_WM_SYNC_REQUEST_COUNTER};
 
     XChangeProperty(display, root, _NET_SUPPORTED, XA_ATOM, 32,
                     PropModeReplace, (unsigned char *)supported,
@@ -1560,31 +3704,31 @@ void handle_client_message(XClientMessageEvent *event)
     {
         // Workspace değiştirme isteği
         int new_workspace = event->data.l[0];
-        if (new_workspace >= 0 && new_workspace < NUM_WORKSPACES)
+        if (new_workspace >= 0 && new_workspace < num_workspaces)
         {
             switch_workspace(new_workspace);
         }
     }
+    else if (event->message_type == _NET_NUMBER_OF_DESKTOPS)
+    {
+        // Workspace sayısını değiştirme isteği
+        set_workspace_count(event->data.l[0]);
+    }
     else if (event->message_type == _NET_ACTIVE_WINDOW)
     {
         // Pencere aktifleştirme isteği
         Window window = event->window;
         // Pencereyi bul ve aktifleştir
-        for (int i = 0; i < NUM_WORKSPACES; i++)
+        Client *c = client_find(window);
+        if (c && c->workspace >= 0)
         {
-            for (int j = 0; j < workspaces[i].window_count; j++)
+            // Eğer pencere gizli bir workspace'te ise, o workspace'e geç
+            if (!workspace_visible(c->workspace))
             {
-                if (workspaces[i].windows[j] == window)
-                {
-                    // Eğer pencere başka bir workspace'te ise, o workspace'e geç
-                    if (i != current_workspace)
-                    {
-                        switch_workspace(i);
-                    }
-                    focus_window(window);
-                    return;
-                }
+                switch_workspace(c->workspace);
             }
+            focus_window(window);
+            raise_window(window);
         }
     }
     else if (event->message_type == _NET_WM_STATE)
@@ -1599,109 +3743,561 @@ void handle_client_message(XClientMessageEvent *event)
     }
 }
 
+// EWMH özelliklerinin yeniden yayınlanması gerektiğini işaretle. Asıl yazma
+// olay grubu sonunda flush_ewmh_properties() içinde, yalnızca gölge kopyadan
+// farklı olan özellikler için yapılır.
 void update_workspace_properties()
 {
-    // Mevcut workspace'i güncelle
-    long data = current_workspace;
-    XChangeProperty(display, root, _NET_CURRENT_DESKTOP, XA_CARDINAL, 32,
-                    PropModeReplace, (unsigned char *)&data, 1);
+    ewmh_dirty = 1;
+}
 
-    // Toplam workspace sayısını güncelle
-    data = NUM_WORKSPACES;
-    XChangeProperty(display, root, _NET_NUMBER_OF_DESKTOPS, XA_CARDINAL, 32,
-                    PropModeReplace, (unsigned char *)&data, 1);
+// _NET_CLIENT_LIST gölgesi (eşleme sırasıyla, pencere sayısıyla büyür)
+static Window *client_list_buffer = NULL;
+static unsigned long client_list_capacity = 0;
+static unsigned long client_list_count = 0;     // Gölgedeki pencere sayısı
+static unsigned long client_list_published = 0; // Sunucuya yazılmış ön ek uzunluğu
+static int client_list_rewrite = 1;             // Tamamı yeniden yazılmalı mı
 
-    // Aktif pencereyi güncelle
-    if (focused_window != None)
+// Yığın sırası: mwm'in kendi yaptığı raise/lower işlemlerinden tutulur,
+// böylece pager'lar ağacı XQueryTree ile dolaşmak zorunda kalmaz
+static Client *stack_bottom = NULL, *stack_top = NULL;
+
+// İstemciyi yığın listesinden çıkar
+static void stack_unlink(Client *c)
+{
+    if (c->stack_below)
+        c->stack_below->stack_above = c->stack_above;
+    else
+        stack_bottom = c->stack_above;
+    if (c->stack_above)
+        c->stack_above->stack_below = c->stack_below;
+    else
+        stack_top = c->stack_below;
+    c->stack_below = c->stack_above = NULL;
+}
+
+// İstemciyi yığının en üstüne taşı
+void stack_raise(Client *c)
+{
+    if (!c->listed || stack_top == c)
+        return;
+    if (c->stack_below || c->stack_above || stack_bottom == c)
+        stack_unlink(c);
+    c->stack_below = stack_top;
+    if (stack_top)
+        stack_top->stack_above = c;
+    else
+        stack_bottom = c;
+    stack_top = c;
+    stacking_dirty = 1;
+    update_workspace_properties();
+}
+
+// İstemciyi yığının en altına taşı
+void stack_lower(Client *c)
+{
+    if (!c->listed || stack_bottom == c)
+        return;
+    stack_unlink(c);
+    c->stack_above = stack_bottom;
+    if (stack_bottom)
+        stack_bottom->stack_below = c;
+    else
+        stack_top = c;
+    stack_bottom = c;
+    stacking_dirty = 1;
+    update_workspace_properties();
+}
+
+// Pencereyi _NET_CLIENT_LIST gölgesinin sonuna ekle
+void client_list_append(Client *c)
+{
+    if (client_list_count == client_list_capacity)
     {
-        XChangeProperty(display, root, _NET_ACTIVE_WINDOW, XA_WINDOW, 32,
-                        PropModeReplace, (unsigned char *)&focused_window, 1);
+        unsigned long capacity = client_list_capacity ? client_list_capacity * 2 : 64;
+        Window *buffer = realloc(client_list_buffer, capacity * sizeof(Window));
+        if (!buffer)
+        {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+        client_list_buffer = buffer;
+        client_list_capacity = capacity;
     }
 
-    // Pencere listesini güncelle
-    Window client_list[MAX_WINDOWS * NUM_WORKSPACES];
-    int client_count = 0;
+    client_list_buffer[client_list_count++] = c->window;
+    c->listed = 1;
 
-    // Her workspace'teki pencereleri ekle
-    for (int i = 0; i < NUM_WORKSPACES; i++)
+    // Yeni eşlenen pencere yığının en üstündedir
+    stack_raise(c);
+}
+
+// Pencereyi _NET_CLIENT_LIST gölgesinden çıkar
+void client_list_remove(Client *c)
+{
+    for (unsigned long i = 0; i < client_list_count; i++)
     {
-        for (int j = 0; j < workspaces[i].window_count; j++)
+        if (client_list_buffer[i] == c->window)
         {
-            Window win = workspaces[i].windows[j];
-            if (win != None)
-            { // None olmayan pencereleri ekle
-                client_list[client_count++] = win;
+            memmove(&client_list_buffer[i], &client_list_buffer[i + 1],
+                    (client_list_count - i - 1) * sizeof(Window));
+            client_list_count--;
+            if (i < client_list_published)
+                client_list_rewrite = 1;
+            break;
+        }
+    }
+    stack_unlink(c);
+    stacking_dirty = 1;
+    c->listed = 0;
+    update_workspace_properties();
+}
+
+// Kök penceredeki tek CARDINAL/WINDOW değerini gölgeden farklıysa yaz
+static void publish_root_value(Atom property, Atom type, long value, long *shadow, int *valid)
+{
+    if (*valid && *shadow == value)
+    {
+        stats.ewmh_suppressed++;
+        return;
+    }
+    XChangeProperty(display, root, property, type, 32,
+                    PropModeReplace, (unsigned char *)&value, 1);
+    *shadow = value;
+    *valid = 1;
+    stats.ewmh_writes++;
+}
+
+// Değişen EWMH özelliklerini yaz (olay grubu sonunda bir kez çağrılır)
+void flush_ewmh_properties()
+{
+    static long current_desktop_shadow, desktop_count_shadow, active_window_shadow;
+    static int current_desktop_valid, desktop_count_valid, active_window_valid;
 
-                // Her pencere için workspace bilgisini güncelle
+    if (!ewmh_dirty)
+        return;
+    ewmh_dirty = 0;
+
+    // Mevcut workspace, workspace sayısı ve aktif pencere
+    publish_root_value(_NET_CURRENT_DESKTOP, XA_CARDINAL, current_workspace,
+                       &current_desktop_shadow, &current_desktop_valid);
+    publish_root_value(_NET_NUMBER_OF_DESKTOPS, XA_CARDINAL, num_workspaces,
+                       &desktop_count_shadow, &desktop_count_valid);
+    publish_root_value(_NET_ACTIVE_WINDOW, XA_WINDOW, focused_window,
+                       &active_window_shadow, &active_window_valid);
+
+    // Yalnızca workspace'i değişen pencerelerin _NET_WM_DESKTOP'u
+    if (desktop_updates_pending)
+    {
+        desktop_updates_pending = 0;
+        for (int i = 0; i < num_workspaces; i++)
+        {
+            for (Client *c = workspaces[i].head; c; c = c->next)
+            {
+                if (c->published_desktop == i)
+                {
+                    stats.ewmh_suppressed++;
+                    continue;
+                }
                 long desktop = i;
-                XChangeProperty(display, win, _NET_WM_DESKTOP, XA_CARDINAL, 32,
+                XChangeProperty(display, c->window, _NET_WM_DESKTOP, XA_CARDINAL, 32,
                                 PropModeReplace, (unsigned char *)&desktop, 1);
+                c->published_desktop = i;
+                stats.ewmh_writes++;
             }
         }
     }
 
-    XChangeProperty(display, root, _NET_CLIENT_LIST, XA_WINDOW, 32,
-                    PropModeReplace, (unsigned char *)client_list, client_count);
-    // Değişiklikleri hemen uygula
-    XSync(display, False);
+    // Pencere listesi: çıkarma varsa tamamı, yalnızca ekleme varsa son kısım
+    if (client_list_rewrite)
+    {
+        XChangeProperty(display, root, _NET_CLIENT_LIST, XA_WINDOW, 32,
+                        PropModeReplace, (unsigned char *)client_list_buffer, client_list_count);
+        client_list_rewrite = 0;
+        stats.ewmh_writes++;
+    }
+    else if (client_list_count > client_list_published)
+    {
+        XChangeProperty(display, root, _NET_CLIENT_LIST, XA_WINDOW, 32,
+                        PropModeAppend,
+                        (unsigned char *)&client_list_buffer[client_list_published],
+                        client_list_count - client_list_published);
+        stats.ewmh_writes++;
+    }
+    else
+    {
+        stats.ewmh_suppressed++;
+    }
+    client_list_published = client_list_count;
+
+    // Yığın sırası (alttan üste)
+    if (stacking_dirty)
+    {
+        static Window *stacking_buffer = NULL;
+        static unsigned long stacking_capacity = 0;
+        if (client_list_count > stacking_capacity)
+        {
+            unsigned long capacity = client_list_capacity;
+            Window *buffer = realloc(stacking_buffer, capacity * sizeof(Window));
+            if (!buffer)
+            {
+                perror("realloc");
+                exit(EXIT_FAILURE);
+            }
+            stacking_buffer = buffer;
+            stacking_capacity = capacity;
+        }
+
+        unsigned long count = 0;
+        for (Client *c = stack_bottom; c; c = c->stack_above)
+        {
+            stacking_buffer[count++] = c->window;
+        }
+        XChangeProperty(display, root, _NET_CLIENT_LIST_STACKING, XA_WINDOW, 32,
+                        PropModeReplace, (unsigned char *)stacking_buffer, count);
+        stacking_dirty = 0;
+        stats.ewmh_writes++;
+    }
+    else
+    {
+        stats.ewmh_suppressed++;
+    }
+
+    // Workspace adları ve görünüm noktaları yalnızca sayı değişince
+    static int desktops_published = 0;
+    if (desktops_published != num_workspaces)
+    {
+        char names[MAX_WORKSPACES * 4];
+        int length = 0;
+        long viewport[MAX_WORKSPACES * 2];
+
+        for (int i = 0; i < num_workspaces; i++)
+        {
+            length += snprintf(names + length, sizeof(names) - length, "%d", i + 1) + 1;
+            viewport[i * 2] = 0;
+            viewport[i * 2 + 1] = 0;
+        }
+        XChangeProperty(display, root, _NET_DESKTOP_NAMES, UTF8_STRING, 8,
+                        PropModeReplace, (unsigned char *)names, length);
+        XChangeProperty(display, root, _NET_DESKTOP_VIEWPORT, XA_CARDINAL, 32,
+                        PropModeReplace, (unsigned char *)viewport, num_workspaces * 2);
+        desktops_published = num_workspaces;
+        workarea_dirty = 1;
+        stats.ewmh_writes += 2;
+    }
+    else
+    {
+        stats.ewmh_suppressed += 2;
+    }
+
+    // Çalışma alanı (her workspace için bağlı olduğu çıkışın alanı)
+    static long workarea_shadow[MAX_WORKSPACES * 4];
+    static int workarea_published = 0;
+    if (workarea_dirty)
+    {
+        workarea_dirty = 0;
+        long workarea[MAX_WORKSPACES * 4];
+        for (int i = 0; i < num_workspaces; i++)
+        {
+            Monitor *mon = &monitors[workspaces[i].monitor];
+            workarea[i * 4] = mon->wx;
+            workarea[i * 4 + 1] = mon->wy;
+            workarea[i * 4 + 2] = mon->wwidth;
+            workarea[i * 4 + 3] = mon->wheight;
+        }
+
+        if (workarea_published != num_workspaces ||
+            memcmp(workarea, workarea_shadow, num_workspaces * 4 * sizeof(long)) != 0)
+        {
+            XChangeProperty(display, root, _NET_WORKAREA, XA_CARDINAL, 32,
+                            PropModeReplace, (unsigned char *)workarea, num_workspaces * 4);
+            memcpy(workarea_shadow, workarea, num_workspaces * 4 * sizeof(long));
+            workarea_published = num_workspaces;
+            stats.ewmh_writes++;
+        }
+        else
+        {
+            stats.ewmh_suppressed++;
+        }
+    }
 }
 
-void handle_strut_properties(Window window)
+// Workspace sayısını çalışırken değiştir (_NET_NUMBER_OF_DESKTOPS isteği).
+// Kaldırılan workspace'lerdeki pencereler kalan son workspace'e taşınır.
+void set_workspace_count(int count)
 {
-    Atom actual_type;
-    int actual_format;
-    unsigned long nitems, bytes_after;
-    unsigned char *data = NULL;
+    if (count < num_monitors)
+        count = num_monitors; // Her çıkışın bir workspace'i olmalı
+    if (count > MAX_WORKSPACES)
+        count = MAX_WORKSPACES;
+    if (count == num_workspaces)
+        return;
 
-    // Önce _NET_WM_STRUT_PARTIAL'ı kontrol et
-    if (XGetWindowProperty(display, window, _NET_WM_STRUT_PARTIAL,
-                           0, 12, False, XA_CARDINAL, &actual_type,
-                           &actual_format, &nitems, &bytes_after,
-                           &data) == Success &&
-        data)
+    if (count < num_workspaces)
     {
-        long *struts = (long *)data;
-        if (nitems == 12)
+        int last = count - 1;
+
+        // Kaldırılacak workspace'leri gösteren çıkışlara kalanlardan birini ver
+        for (int m = 0; m < num_monitors; m++)
         {
-            // Strut değerlerini işle
-            if (struts[2] > 0)
-            { // Top strut
-                effective_screen_y = struts[2];
-                effective_screen_height = screen_height - struts[2];
+            if (monitors[m].workspace > last)
+            {
+                int workspace = first_hidden_workspace();
+                monitor_show_workspace(m, workspace);
             }
-            else if (struts[3] > 0)
-            { // Bottom strut
-                effective_screen_height = screen_height - struts[3];
+        }
+
+        for (int i = count; i < num_workspaces; i++)
+        {
+            while (workspaces[i].head)
+            {
+                move_window_to_workspace(workspaces[i].head->window, i, last);
             }
         }
-        XFree(data);
     }
-    // Sonra _NET_WM_STRUT'u kontrol et
-    else if (XGetWindowProperty(display, window, _NET_WM_STRUT,
-                                0, 4, False, XA_CARDINAL, &actual_type,
-                                &actual_format, &nitems, &bytes_after,
-                                &data) == Success &&
-             data)
+
+    resize_workspaces(count);
+    workarea_dirty = 1;
+    LOG(LOG_INFO, "Workspace sayısı: %d", num_workspaces);
+
+    update_workspace_properties();
+}
+
+// Tek bir X olayını işle
+void handle_event(XEvent *event)
+{
+    stats.events++;
+
+#ifdef XRANDR
+    if (randr_event_base >= 0 && event->type == randr_event_base + RRScreenChangeNotify)
+    {
+        handle_screen_change(event);
+        return;
+    }
+#endif
+    if (xkb_event_base >= 0 && event->type == xkb_event_base)
     {
-        long *struts = (long *)data;
-        if (nitems == 4)
+        // Değiştirici durumu değişti: Alt bırakıldıysa Alt + Tab döngüsü biter
+        XkbEvent *xkb = (XkbEvent *)event;
+        if (xkb->any.xkb_type == XkbStateNotify && focus_cycling &&
+            !(xkb->state.mods & MODKEY))
+            end_focus_cycle();
+        return;
+    }
+    if (sync_event_base >= 0 && event->type == sync_event_base + XSyncAlarmNotify)
+    {
+        handle_sync_alarm((XSyncAlarmNotifyEvent *)event);
+        return;
+    }
+
+    switch (event->type)
+    {
+    case ClientMessage:
+        handle_client_message(&event->xclient);
+        break;
+    case MapRequest:
+        handle_map_request(&event->xmaprequest);
+        break;
+    case DestroyNotify:
+        handle_destroy_notify(&event->xdestroywindow);
+        break;
+    case ConfigureRequest:
+        handle_configure_request(&event->xconfigurerequest);
+        break;
+    case UnmapNotify:
+        handle_unmap_notify(&event->xunmap);
+        break;
+    case PropertyNotify:
+        handle_property_notify(&event->xproperty);
+        break;
+    case ButtonPress:
+        handle_button_press(&event->xbutton);
+        break;
+    case ButtonRelease:
+        stop_drag(&event->xbutton);
+        break;
+    case MotionNotify:
+        handle_motion(&event->xmotion);
+        break;
+    case KeyPress:
+        handle_key_press(&event->xkey);
+        break;
+    case KeyRelease:
+        handle_key_release(&event->xkey);
+        break;
+    case EnterNotify:
+        handle_enter_notify(&event->xcrossing);
+        break;
+    case ConfigureNotify:
+        if (event->xconfigure.window == root)
         {
-            if (struts[2] > 0)
-            { // Top strut
-                effective_screen_y = struts[2];
-                effective_screen_height = screen_height - struts[2];
-            }
-            else if (struts[3] > 0)
-            { // Bottom strut
-                effective_screen_height = screen_height - struts[3];
-            }
+            handle_screen_change(event);
+        }
+        else
+        {
+            handle_configure_notify(&event->xconfigure);
+        }
+        break;
+    case MapNotify:
+        if (event->xmap.window == switch_reveal_window)
+        {
+            finish_switch_measurement();
+        }
+        break;
+    case Expose:
+        if (event->xexpose.window == notification_window && event->xexpose.count == 0)
+        {
+            // Önceden çizilmiş numarayı kopyala (yeniden gösterme yok)
+            draw_workspace_notification();
+        }
+        break;
+    }
+}
+
+// timerfd ve SIGUSR1/SIGUSR2 için signalfd oluştur
+void init_event_sources()
+{
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd < 0)
+    {
+        perror("timerfd_create");
+        exit(EXIT_FAILURE);
+    }
+
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGUSR1);
+    sigaddset(&mask, SIGUSR2);
+    sigprocmask(SIG_BLOCK, &mask, NULL);
+    signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signal_fd < 0)
+    {
+        perror("signalfd");
+    }
+}
+
+// Bekleyen sinyalleri işle
+void handle_signals()
+{
+    struct signalfd_siginfo info;
+    while (read(signal_fd, &info, sizeof(info)) == sizeof(info))
+    {
+        if (info.ssi_signo == SIGUSR1)
+        {
+            dump_stats();
+        }
+        else if (info.ssi_signo == SIGUSR2)
+        {
+            log_dump();
+        }
+    }
+}
+
+// Ana döngü: X bağlantısı, timerfd ve signalfd üzerinde bloklanır.
+// Kuyrukta olay kalmayınca çıkış tamponu boşaltılır ve poll() ile uyunur,
+// böylece boştayken hiç uyanma olmaz.
+void run_event_loop()
+{
+    XEvent event;
+    struct pollfd fds[3];
+    int nfds = 2;
+
+    fds[0].fd = ConnectionNumber(display);
+    fds[0].events = POLLIN;
+    fds[1].fd = timer_fd;
+    fds[1].events = POLLIN;
+    if (signal_fd >= 0)
+    {
+        fds[2].fd = signal_fd;
+        fds[2].events = POLLIN;
+        nfds = 3;
+    }
+
+    while (1)
+    {
+        // Xlib kuyruğunu (ve sokette okunmayı bekleyenleri) tamamen boşalt
+        while (XEventsQueued(display, QueuedAfterReading) > 0)
+        {
+            XNextEvent(display, &event);
+            handle_event(&event);
+        }
+
+        // Olay grubu bitti: ekran değiştiyse çıkışları bir kez hesapla,
+        // kirli workspace'leri birer kez düzenle ve değişen EWMH
+        // özelliklerini yaz
+        flush_screen_change();
+        flush_layouts();
+        flush_ewmh_properties();
+
+        // Düzenleme sırasında kuyruğa olay okunduysa uyumadan önce işle
+        if (QLength(display) > 0)
+        {
+            continue;
+        }
+
+        // Döngü başına tek gönderim noktası: uyumadan önce tüm istekleri
+        // sunucuya gönder (olay işleyicileri XSync/XFlush çağırmaz)
+        XFlush(display);
+
+        if (poll(fds, nfds, -1) < 0)
+        {
+            continue; // EINTR
+        }
+        stats.wakeups++;
+
+        if (fds[1].revents & POLLIN)
+        {
+            timer_dispatch();
+        }
+        if (nfds > 2 && (fds[2].revents & POLLIN))
+        {
+            handle_signals();
+        }
+        if (fds[0].revents & (POLLHUP | POLLERR))
+        {
+            fprintf(stderr, "X sunucusu bağlantısı kapandı.\n");
+            break;
         }
-        XFree(data);
     }
 }
 
 int main()
 {
+    start_time_ms = now_ms();
+    stats.sync_second_start = start_time_ms;
+
+    // Gizli workspace pencerelerinin gizlenme biçimi (unmap veya park)
+    const char *hide_env = getenv("MWM_HIDE");
+    if (hide_env)
+    {
+        hide_strategy = strcmp(hide_env, "park") == 0 ? HIDE_PARK : HIDE_UNMAP;
+    }
+    // Değişimde sunucu kilidi (karşılaştırma için)
+    const char *grab_env = getenv("MWM_SWITCH_GRAB");
+    if (grab_env)
+    {
+        switch_grab_server = atoi(grab_env) != 0;
+    }
+
+    const char *focus_env = getenv("MWM_FOCUS_DELAY");
+    if (focus_env)
+    {
+        focus_delay_ms = atoi(focus_env);
+    }
+
+    const char *outline_env = getenv("MWM_OUTLINE");
+    if (outline_env)
+    {
+        outline_drag_default = atoi(outline_env) != 0;
+    }
+
+    // Çalışma zamanı günlük seviyesi (derleme zamanı seviyesini aşamaz)
+    const char *level_env = getenv("MWM_LOG_LEVEL");
+    if (level_env)
+    {
+        log_level = atoi(level_env);
+    }
+
     display = XOpenDisplay(NULL);
     if (!display)
     {
@@ -1720,41 +4316,103 @@ int main()
     // Tuş kodlarını başlat - YENİ
     init_keybindings();
 
-    // Root pencere için olay maskesini güncelle
+    // Root pencere için olay maskesini güncelle. SubstructureRedirect'i
+    // başka bir pencere yöneticisi tutuyorsa BadAccess döner; bunu görmek
+    // için burada bilinçli olarak bir gidiş-dönüş yapılır.
+    XSetErrorHandler(startup_error_handler);
     XSelectInput(display, root,
                  SubstructureRedirectMask |
                      SubstructureNotifyMask |
+                     StructureNotifyMask | // Kök boyutu değişimi (ConfigureNotify)
                      ButtonPressMask |
                      ButtonReleaseMask |
                      PointerMotionMask |
                      PropertyChangeMask |
                      KeyPressMask);
+    wm_sync();
+    if (other_wm_running)
+    {
+        fprintf(stderr, "Başka bir pencere yöneticisi zaten çalışıyor.\n");
+        XCloseDisplay(display);
+        return 1;
+    }
+    XSetErrorHandler(error_handler);
+
+#ifdef XRANDR
+    // Çıkış takma/çıkarma ve çözünürlük değişikliklerini dinle
+    int randr_error_base;
+    if (XRRQueryExtension(display, &randr_event_base, &randr_error_base))
+    {
+        XRRSelectInput(display, root, RRScreenChangeNotifyMask);
+    }
+    else
+    {
+        randr_event_base = -1;
+    }
+#endif
+
+    // Değiştirici durum olayları: Alt + Tab döngüsünün bitişi klavye
+    // yakalamadan ve tuş durumu sorgulamadan buradan anlaşılır
+    int xkb_opcode, xkb_error_base, xkb_major = XkbMajorVersion, xkb_minor = XkbMinorVersion;
+    if (XkbQueryExtension(display, &xkb_opcode, &xkb_event_base, &xkb_error_base,
+                          &xkb_major, &xkb_minor))
+    {
+        XkbSelectEventDetails(display, XkbUseCoreKbd, XkbStateNotify,
+                              XkbModifierStateMask, XkbModifierStateMask);
+    }
+    else
+    {
+        xkb_event_base = -1;
+    }
+
+    // İstemci hızında boyutlandırma (_NET_WM_SYNC_REQUEST) için Sync eklentisi
+    int sync_error_base, sync_major, sync_minor;
+    if (!XSyncQueryExtension(display, &sync_event_base, &sync_error_base) ||
+        !XSyncInitialize(display, &sync_major, &sync_minor))
+    {
+        sync_event_base = -1;
+    }
 
     // Klavye olaylarını root pencereye yönlendir
+    update_numlock_mask();
     grab_keys(); // YENİ - Önceki tüm XGrabKey çağrıları yerine
 
     // Normal fare işaretçisini oluştur
     normal_cursor = XCreateFontCursor(display, XC_left_ptr);
+    move_cursor = XCreateFontCursor(display, XC_fleur);
+    resize_cursor = XCreateFontCursor(display, XC_sizing);
+
+    // XOR çerçeve: pencerelerin üstüne de çizilir, ikinci çizim siler
+    XGCValues outline_values;
+    outline_values.function = GXxor;
+    outline_values.foreground = WhitePixel(display, DefaultScreen(display)) ^
+                                BlackPixel(display, DefaultScreen(display));
+    outline_values.line_width = BORDER_WIDTH;
+    outline_values.subwindow_mode = IncludeInferiors;
+    outline_gc = XCreateGC(display, root,
+                           GCFunction | GCForeground | GCLineWidth | GCSubwindowMode,
+                           &outline_values);
     XDefineCursor(display, root, normal_cursor);
 
-    XSetErrorHandler(error_handler);
-
-    printf("Pencere yöneticisi başlatıldı...\n");
-    printf("Alt + 1-9: Workspace değiştir\n");
-    printf("Alt + Shift + 1-9: Aktif pencereyi belirtilen workspace'e taşı\n");
-    printf("Alt + d: dmenu çalıştır\n");
-    printf("Alt + q: Aktif pencereyi kapat\n");
-    printf("Alt + t: Tiling/Floating mod değiştir\n");
-    printf("Alt + l: Ana bölgeyi %%1 genişlet (sağa doğru)\n");
-    printf("Alt + h: Ana bölgeyi %%1 daralt (sola doğru)\n");
-    printf("Alt + Enter: Ana pencere ile değiştir\n");
-    printf("Alt + g: Boşlukları aç/kapa\n");
-    printf("Alt + j/k: İç boşlukları azalt/artır\n");
-    printf("Alt + Shift + j/k: Dış boşlukları azalt/artır\n");
-    printf("Alt + Sol/Sağ: Önceki/Sonraki workspace'e geç\n");
-    printf("Alt + Tab: Workspace içinde pencereler arası geçiş yap\n");
-    printf("Alt + Shift + q: X oturmunu kapatır\n");
-    printf("Alt + Shift + Enter: Terminal açar\n");
+    LOG(LOG_INFO, "Pencere yöneticisi başlatıldı...");
+    LOG(LOG_INFO, "Alt + 1-9: Workspace değiştir");
+    LOG(LOG_INFO, "Alt + Shift + 1-9: Aktif pencereyi belirtilen workspace'e taşı");
+    LOG(LOG_INFO, "Alt + d: dmenu çalıştır");
+    LOG(LOG_INFO, "Alt + q: Aktif pencereyi kapat");
+    LOG(LOG_INFO, "Alt + t: Tiling/Floating mod değiştir");
+    LOG(LOG_INFO, "Alt + Space: Yerleşimi değiştir (tile, monocle, grid, bstack, multicolumn, spiral)");
+    LOG(LOG_INFO, "Alt + i/u: Ana bölgedeki pencere sayısını artır/azalt");
+    LOG(LOG_INFO, "Alt + l: Ana bölgeyi %%1 genişlet (sağa doğru)");
+    LOG(LOG_INFO, "Alt + h: Ana bölgeyi %%1 daralt (sola doğru)");
+    LOG(LOG_INFO, "Alt + Enter: Ana pencere ile değiştir");
+    LOG(LOG_INFO, "Alt + g: Boşlukları aç/kapa");
+    LOG(LOG_INFO, "Alt + j/k: İç boşlukları azalt/artır");
+    LOG(LOG_INFO, "Alt + Shift + j/k: Dış boşlukları azalt/artır");
+    LOG(LOG_INFO, "Alt + Sol/Sağ: Önceki/Sonraki workspace'e geç");
+    LOG(LOG_INFO, "Alt + Tab: Workspace içinde pencereler arası geçiş yap");
+    LOG(LOG_INFO, "Alt + , / .: Önceki/Sonraki çıkışa (monitöre) geç");
+    LOG(LOG_INFO, "Alt + Shift + q: X oturmunu kapatır");
+    LOG(LOG_INFO, "Alt + Shift + Enter: Terminal açar");
 
     // EWMH atomlarını başlat
     init_atoms();
@@ -1765,65 +4423,23 @@ int main()
     // İlk workspace özelliklerini ayarla
     update_workspace_properties();
 
-    // Ana döngü
-    XEvent event;
-    while (1)
-    {
-        // Bildirim zamanlayıcısını kontrol et
-        check_notification_timeout();
+    // Zamanlayıcı ve sinyal tanımlayıcılarını hazırla
+    init_event_sources();
 
-        while (XPending(display))
-        {
-            XNextEvent(display, &event);
-
-            switch (event.type)
-            {
-            case ClientMessage:
-                handle_client_message(&event.xclient);
-                break;
-            case MapRequest:
-                handle_map_request(&event.xmaprequest);
-                break;
-            case DestroyNotify:
-                handle_destroy_notify(&event.xdestroywindow);
-                break;
-            case ConfigureRequest:
-                handle_configure_request(&event.xconfigurerequest);
-                break;
-            case ButtonPress:
-                handle_button_press(&event.xbutton);
-                break;
-            case ButtonRelease:
-                stop_drag(&event.xbutton);
-                break;
-            case MotionNotify:
-                handle_motion(&event.xmotion);
-                break;
-            case KeyPress:
-                handle_key_press(&event.xkey);
-                break;
-            case EnterNotify:
-                if (event.xcrossing.mode == NotifyNormal && !is_switching_workspace)
-                {
-                    focus_window(event.xcrossing.window);
-                }
-                break;
-            case Expose:
-                if (event.xexpose.window == notification_window)
-                {
-                    // Bildirim penceresini yeniden çiz
-                    show_workspace_notification(current_workspace);
-                }
-                break;
-            }
-        }
+    // Başlangıç kayıtlarını hemen yaz
+    log_flush();
 
-        usleep(1000); // CPU kullanımını azaltmak için kısa bekleme
-    }
+    // Ana döngü
+    run_event_loop();
 
     // Program sonunda temizlik
+    log_flush();
     XUngrabKey(display, AnyKey, AnyModifier, root);
     XFreeCursor(display, normal_cursor);
+    XFreeCursor(display, move_cursor);
+    XFreeCursor(display, resize_cursor);
+    XFreeGC(display, outline_gc);
+    free_workspace_notification();
     XCloseDisplay(display);
     return 0;
 }